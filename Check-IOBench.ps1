@@ -0,0 +1,23 @@
+$ErrorActionPreference = "Stop"
+
+# Runs a built iobench over a scratch file for option sets that have broken before. Each run
+# must exit with code 0.
+
+function RunCheck($name, $arguments) {
+    Write-Host "== $name"
+    & $iobench @arguments $scratchFile
+    if ($LastExitCode -ne 0) { throw "Check '$name' failed with exit code $LastExitCode." }
+}
+
+$Configuration = 'Release'
+$iobenchDir = split-path -parent $MyInvocation.MyCommand.Definition
+$iobench = "$iobenchDir\ExxonMobil.IOBench.Cli\bin\$Configuration\iobench.exe"
+$scratchFile = "$env:TEMP\iobench-check.bin"
+
+try {
+    # Every conditioning pass and round runs its own asynchronous loop over the file.
+    RunCheck "precondition passes and rounds" @('-op=rr', '-fs=64', '-bs=64', '-precond=2,1', '-reprecond')
+    RunCheck "precondition then overwrite" @('-op=sw', '-fs=64', '-bs=64', '-precond=2,1', '-reprecond')
+} finally {
+    if (Test-Path $scratchFile) { rm $scratchFile -Force }
+}
@@ -0,0 +1,403 @@
+﻿// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Reflection;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using ExxonMobil.IOBench.Core;
+using ExxonMobil.Shared.Logging;
+
+namespace ExxonMobil.IOBench.Cli
+{
+	// Runs one benchmark across several worker processes. Workers connect over TCP, prepare 
+	// their files and report READY; the coordinator then releases them all with START. While 
+	// running they send SAMPLE lines with their progress and finish with a RESULT line carrying 
+	// their transfer times and latency histogram, or an ERROR line.
+	class Coordinator
+	{
+		public const string Ready = "READY";
+		public const string Start = "START";
+		public const string Cancel = "CANCEL";
+		public const string Sample = "SAMPLE";
+		public const string Result = "RESULT";
+		public const string Error = "ERROR";
+
+		public Coordinator(int workerCount, ushort port, bool spawn, ILogger logger)
+		{
+			this.workerCount = workerCount;
+			this.port = port;
+			this.spawn = spawn;
+			this.logger = logger;
+		}
+
+		// Worker i of a spawned run gets its own file: {0} in the path is replaced with i, 
+		// otherwise .i is appended.
+		public static string WorkerPath(string path, int index)
+		{
+			var id = index.ToString(CultureInfo.InvariantCulture);
+			return path.Contains("{0}") ? path.Replace("{0}", id) : path + "." + id;
+		}
+
+		public void Run(BenchmarkConfiguration config, IList<string> workerArguments, string path, int intervalMilliseconds)
+		{
+			var listener = new TcpListener(spawn ? IPAddress.Loopback : IPAddress.Any, port);
+			listener.Start();
+			var processes = new List<Process>();
+			try
+			{
+				var endpoint = (IPEndPoint)listener.LocalEndpoint;
+				logger.Log(String.Format("Waiting for {0} workers on port {1}.", workerCount, endpoint.Port), Category.Info);
+				if (spawn)
+				{
+					for (int i = 0; i < workerCount; i++)
+						processes.Add(SpawnWorker(workerArguments, path == null ? null : WorkerPath(path, i), endpoint.Port));
+				}
+				AcceptWorkers(listener, processes);
+			}
+			finally
+			{
+				listener.Stop();
+			}
+			WaitForReady();
+
+			var cts = new CancellationTokenSource();
+			Console.CancelKeyPress += (s, e) => { cts.Cancel(); e.Cancel = true; };
+
+			// The barrier: every worker is ready before any is told to start.
+			var clock = Stopwatch.StartNew();
+			foreach (var worker in workers)
+				worker.Send(Start);
+			var listeners = workers.Select(w => Task.Factory.StartNew(w.Listen, TaskCreationOptions.LongRunning)).ToArray();
+
+			bool cancelSent = false;
+			long lastBytes = 0, lastBlocks = 0;
+			double lastSeconds = 0;
+			while (!Task.WaitAll(listeners, intervalMilliseconds))
+			{
+				if (cts.IsCancellationRequested && !cancelSent)
+				{
+					foreach (var worker in workers)
+						worker.Send(Cancel);
+					cancelSent = true;
+				}
+
+				double seconds = clock.Elapsed.TotalSeconds;
+				long bytes = workers.Sum(w => w.Bytes);
+				long blocks = workers.Sum(w => w.Blocks);
+				Console.WriteLine(String.Format(DataSizeFormatter.Default, "{0,7:0.0}s  {1,-13:FS} {2,10:0.0 'MiB/s'} {3,10:0 'Op/s'}   {4}/{5} running",
+					seconds, bytes, (bytes - lastBytes) / (seconds - lastSeconds) / (1024 * 1024), (blocks - lastBlocks) / (seconds - lastSeconds),
+					workers.Count(w => !w.Finished), workerCount));
+				lastBytes = bytes;
+				lastBlocks = blocks;
+				lastSeconds = seconds;
+			}
+			Console.WriteLine();
+
+			PrintSummary(config);
+
+			foreach (var process in processes)
+				process.Dispose();
+			foreach (var worker in workers)
+				worker.Dispose();
+
+			var failed = workers.Where(w => w.ErrorMessage != null).ToList();
+			foreach (var worker in failed)
+				logger.Log(String.Format("Worker {0} ({1}): {2}", worker.Index, worker.Name, worker.ErrorMessage), Category.Exception);
+			if (failed.Count > 0)
+				throw new IOBenchCliException(failed.Count + " of " + workerCount + " workers did not complete.");
+		}
+
+		private Process SpawnWorker(IList<string> workerArguments, string path, int listenPort)
+		{
+			var arguments = workerArguments.Concat(new[] { "-worker=127.0.0.1:" + listenPort });
+			if (path != null)
+				arguments = arguments.Concat(new[] { path });
+
+			var startInfo = new ProcessStartInfo(Assembly.GetEntryAssembly().Location, String.Join(" ", arguments.Select(QuoteArgument)))
+			{
+				UseShellExecute = false,
+				CreateNoWindow = true
+			};
+			return Process.Start(startInfo);
+		}
+
+		private static string QuoteArgument(string argument)
+		{
+			if (argument.Length > 0 && argument.IndexOfAny(new[] { ' ', '\t', '"' }) < 0)
+				return argument;
+			return "\"" + argument.Replace("\"", "\\\"") + "\"";
+		}
+
+		private void AcceptWorkers(TcpListener listener, List<Process> processes)
+		{
+			var deadline = Stopwatch.StartNew();
+			while (workers.Count < workerCount)
+			{
+				var accept = listener.AcceptTcpClientAsync();
+				while (!accept.Wait(500))
+				{
+					var exited = processes.FirstOrDefault(p => p.HasExited);
+					if (exited != null)
+						throw new IOBenchCliException(String.Format("Worker {0} exited with code {1} before it was ready.", processes.IndexOf(exited), exited.ExitCode))
+						{
+							HelpText = "Spawned workers log their exceptions to " + Path.GetTempPath() + "iobench-exception.txt."
+						};
+					if (deadline.ElapsedMilliseconds > AcceptTimeoutMilliseconds)
+						throw new IOBenchCliException(String.Format("Only {0} of {1} workers connected.", workers.Count, workerCount));
+				}
+
+				workers.Add(new WorkerConnection(workers.Count, accept.Result));
+			}
+		}
+
+		// Preparing can precondition or preallocate a large file, so there is no limit on how 
+		// long a connected worker takes to report READY. A worker that fails reports ERROR 
+		// instead, and one that dies closes its connection.
+		private void WaitForReady()
+		{
+			logger.Log("Waiting for the workers to prepare.", Category.Info);
+			foreach (var worker in workers)
+			{
+				var hello = worker.ReadLine(Timeout.Infinite);
+				if (hello == null || !hello.StartsWith(Ready))
+					throw new IOBenchCliException(String.Format("Worker {0} ({1}) failed to start: {2}", worker.Index, worker.Name, 
+						hello == null ? "connection closed" : hello.Substring(hello.IndexOf('\t') + 1)));
+			}
+		}
+
+		// Histograms are merged bucket by bucket, so the quantiles are those of every request 
+		// in the run rather than an average of per-worker quantiles. The goodput window runs 
+		// from the first transfer start to the last transfer end, each measured by the worker 
+		// from when it received START, so setup and reporting are left out of it.
+		private void PrintSummary(BenchmarkConfiguration config)
+		{
+			var completed = workers.Where(w => w.Latency != null).ToList();
+			var latency = new LatencyHistogram();
+			foreach (var worker in completed)
+				latency.Merge(worker.Latency);
+
+			long bytes = workers.Sum(w => w.Bytes);
+			long blocks = workers.Sum(w => w.Blocks);
+			double window = completed.Count > 0 ? completed.Max(w => w.TransferEndSeconds) - completed.Min(w => w.TransferStartSeconds) : 0;
+
+			Console.WriteLine("Coordinated Run     {0} of {1} workers completed", completed.Count, workerCount);
+			Console.WriteLine(String.Format(DataSizeFormatter.Default, "Transferred:        {0:FS} in {1} blocks", bytes, blocks));
+			if (window > 0)
+			{
+				Console.WriteLine("Aggregate Goodput:  {0:0.0} MiB/s over {1:0.00} s", bytes / window / (1024 * 1024), window);
+				Console.WriteLine("Aggregate IOPS:     {0:0}", blocks / window);
+			}
+			Console.WriteLine("Mean:               {0:0.0} us", latency.MeanMicroseconds);
+			foreach (var q in new[] { 0.5, 0.9, 0.99, 0.999 })
+				Console.WriteLine("{0,-20}{1} us", String.Format("p{0}:", q * 100), latency.Quantile(q));
+			Console.WriteLine();
+
+			Console.WriteLine("Worker  Transferred    Goodput        p50          p99");
+			foreach (var worker in completed)
+			{
+				Console.WriteLine(String.Format(DataSizeFormatter.Default, "{0,-7} {1,-14:FS} {2,-14:0.0 'MiB/s'} {3,-12} {4}",
+					worker.Index, worker.Bytes, worker.TransferSeconds > 0 ? worker.Bytes / worker.TransferSeconds / (1024 * 1024) : 0,
+					worker.Latency.Quantile(0.5) + " us", worker.Latency.Quantile(0.99) + " us"));
+			}
+			Console.WriteLine();
+		}
+
+		private const int AcceptTimeoutMilliseconds = 60000;
+
+		private readonly int workerCount;
+		private readonly ushort port;
+		private readonly bool spawn;
+		private readonly ILogger logger;
+		private readonly List<WorkerConnection> workers = new List<WorkerConnection>();
+
+		private class WorkerConnection : IDisposable
+		{
+			public WorkerConnection(int index, TcpClient client)
+			{
+				Index = index;
+				Name = client.Client.RemoteEndPoint.ToString();
+				this.client = client;
+				var stream = client.GetStream();
+				reader = new StreamReader(stream, Encoding.ASCII);
+				writer = new StreamWriter(stream, Encoding.ASCII) { AutoFlush = true, NewLine = "\n" };
+			}
+
+			public int Index { get; private set; }
+			public string Name { get; private set; }
+			public long Bytes { get { return Interlocked.Read(ref bytes); } }
+			public long Blocks { get { return Interlocked.Read(ref blocks); } }
+			public bool Finished { get; private set; }
+			public double TransferSeconds { get; private set; }
+			public double TransferStartSeconds { get; private set; }
+			public double TransferEndSeconds { get; private set; }
+			public LatencyHistogram Latency { get; private set; }
+			public string ErrorMessage { get; private set; }
+
+			public string ReadLine(int timeoutMilliseconds)
+			{
+				client.GetStream().ReadTimeout = timeoutMilliseconds;
+				return reader.ReadLine();
+			}
+
+			public void Send(string message)
+			{
+				lock (writer)
+				{
+					try { writer.WriteLine(message); }
+					catch (IOException) { }
+				}
+			}
+
+			public void Listen()
+			{
+				client.GetStream().ReadTimeout = Timeout.Infinite;
+				try
+				{
+					string line;
+					while ((line = reader.ReadLine()) != null)
+					{
+						var fields = line.Split('\t');
+						if (fields[0] == Sample && fields.Length >= 3)
+						{
+							Interlocked.Exchange(ref bytes, long.Parse(fields[1], CultureInfo.InvariantCulture));
+							Interlocked.Exchange(ref blocks, long.Parse(fields[2], CultureInfo.InvariantCulture));
+						}
+						else if (fields[0] == Result && fields.Length >= 7)
+						{
+							Interlocked.Exchange(ref bytes, long.Parse(fields[1], CultureInfo.InvariantCulture));
+							Interlocked.Exchange(ref blocks, long.Parse(fields[2], CultureInfo.InvariantCulture));
+							TransferSeconds = double.Parse(fields[3], CultureInfo.InvariantCulture);
+							TransferStartSeconds = double.Parse(fields[4], CultureInfo.InvariantCulture);
+							TransferEndSeconds = double.Parse(fields[5], CultureInfo.InvariantCulture);
+							Latency = LatencyHistogram.FromArray(fields[6].Split(',').Select(c => long.Parse(c, CultureInfo.InvariantCulture)).ToArray());
+							break;
+						}
+						else if (fields[0] == Error)
+						{
+							ErrorMessage = fields.Length > 1 ? fields[1] : "Unknown error.";
+							break;
+						}
+					}
+					if (line == null)
+						ErrorMessage = "Connection closed before the worker reported a result.";
+				}
+				catch (IOException e)
+				{
+					ErrorMessage = e.Message;
+				}
+				Finished = true;
+			}
+
+			public void Dispose()
+			{
+				client.Close();
+			}
+
+			private readonly TcpClient client;
+			private readonly StreamReader reader;
+			private readonly StreamWriter writer;
+			private long bytes;
+			private long blocks;
+		}
+	}
+
+	// The worker side of a coordinated run.
+	static class CoordinatedWorker
+	{
+		public static void Run(Benchmark benchmark, string coordinator, CancellationTokenSource cts, int intervalMilliseconds)
+		{
+			var separator = coordinator.LastIndexOf(':');
+			ushort port;
+			if (separator < 1 || !ushort.TryParse(coordinator.Substring(separator + 1), out port))
+				throw new IOBenchCliException("Invalid coordinator address: " + coordinator) { HelpText = "Use -worker=host:port." };
+
+			using (var client = new TcpClient(coordinator.Substring(0, separator), port))
+			{
+				var stream = client.GetStream();
+				var reader = new StreamReader(stream, Encoding.ASCII);
+				var writer = new StreamWriter(stream, Encoding.ASCII) { AutoFlush = true, NewLine = "\n" };
+
+				// Setup happens before READY, so START releases every worker straight into its transfer.
+				try
+				{
+					using (cts.Token.Register(benchmark.Stop))
+						benchmark.Prepare();
+				}
+				catch (Exception e)
+				{
+					writer.WriteLine(Coordinator.Error + "\t" + ErrorField(e));
+					throw;
+				}
+				if (cts.IsCancellationRequested)
+				{
+					writer.WriteLine(Coordinator.Error + "\tCanceled.");
+					return;
+				}
+
+				writer.WriteLine(Coordinator.Ready + "\t" + Environment.MachineName + ":" + Process.GetCurrentProcess().Id);
+				if (reader.ReadLine() != Coordinator.Start)
+					return;
+
+				var started = Stopwatch.GetTimestamp();
+				var benchmarkTask = benchmark.Start(cts.Token);
+				Task.Factory.StartNew(() =>
+				{
+					try
+					{
+						string line;
+						while ((line = reader.ReadLine()) != null)
+						{
+							if (line == Coordinator.Cancel)
+								cts.Cancel();
+						}
+					}
+					catch (IOException) { }
+					catch (ObjectDisposedException) { }
+				});
+
+				while (Task.WaitAny(new Task[] { benchmarkTask }, intervalMilliseconds) < 0)
+					writer.WriteLine(String.Format(CultureInfo.InvariantCulture, "{0}\t{1}\t{2}", Coordinator.Sample, benchmark.BytesTransferred, benchmark.BlocksTransferred));
+
+				if (benchmarkTask.IsFaulted)
+					writer.WriteLine(Coordinator.Error + "\t" + ErrorField(benchmarkTask.Exception.GetBaseException()));
+				else if (benchmarkTask.IsCanceled)
+					writer.WriteLine(Coordinator.Error + "\tCanceled.");
+				else
+					writer.WriteLine(String.Format(CultureInfo.InvariantCulture, "{0}\t{1}\t{2}\t{3}\t{4}\t{5}\t{6}", Coordinator.Result, 
+						benchmark.BytesTransferred, benchmark.BlocksTransferred, benchmark.TransferTime.TotalSeconds, 
+						SecondsSince(started, benchmark.TransferStartTimestamp), SecondsSince(started, benchmark.TransferEndTimestamp),
+						String.Join(",", benchmark.Latency.ToArray())));
+			}
+		}
+
+		// A run canceled before its transfer began has no transfer timestamps.
+		private static double SecondsSince(long started, long timestamp)
+		{
+			return timestamp == 0 ? 0 : (double)(timestamp - started) / Stopwatch.Frequency;
+		}
+
+		private static string ErrorField(Exception e)
+		{
+			return e.Message.Replace('\t', ' ').Replace('\n', ' ').Replace('\r', ' ');
+		}
+	}
+}
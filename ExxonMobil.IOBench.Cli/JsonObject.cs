@@ -0,0 +1,126 @@
+﻿// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Linq;
+using System.Text;
+
+namespace ExxonMobil.IOBench.Cli
+{
+	// Minimal JSON object for the metrics output. Values may be strings, numbers, booleans, 
+	// enums (written as their names), nested objects, sequences of those, or null.
+	class JsonObject
+	{
+		private readonly List<KeyValuePair<string, object>> members = new List<KeyValuePair<string, object>>();
+
+		public JsonObject Add(string name, object value)
+		{
+			members.Add(new KeyValuePair<string, object>(name, value));
+			return this;
+		}
+
+		// Every public readable property of the object, in declaration order.
+		public static JsonObject FromProperties(object source)
+		{
+			var json = new JsonObject();
+			foreach (var property in source.GetType().GetProperties().Where(p => p.CanRead && p.GetIndexParameters().Length == 0))
+				json.Add(property.Name, property.GetValue(source));
+			return json;
+		}
+
+		public override string ToString()
+		{
+			var text = new StringBuilder();
+			Write(text, this);
+			return text.ToString();
+		}
+
+		private static void Write(StringBuilder text, object value)
+		{
+			if (value == null)
+				text.Append("null");
+			else if (value is JsonObject)
+			{
+				text.Append('{');
+				bool first = true;
+				foreach (var member in ((JsonObject)value).members)
+				{
+					if (!first)
+						text.Append(',');
+					first = false;
+					WriteString(text, member.Key);
+					text.Append(':');
+					Write(text, member.Value);
+				}
+				text.Append('}');
+			}
+			else if (value is string)
+				WriteString(text, (string)value);
+			else if (value is bool)
+				text.Append((bool)value ? "true" : "false");
+			else if (value is Enum)
+				WriteString(text, value.ToString());
+			else if (value is double || value is float)
+			{
+				double number = Convert.ToDouble(value);
+				if (Double.IsNaN(number) || Double.IsInfinity(number))
+					text.Append("null");
+				else
+					text.Append(number.ToString("R", CultureInfo.InvariantCulture));
+			}
+			else if (value is IEnumerable)
+			{
+				text.Append('[');
+				bool first = true;
+				foreach (var item in (IEnumerable)value)
+				{
+					if (!first)
+						text.Append(',');
+					first = false;
+					Write(text, item);
+				}
+				text.Append(']');
+			}
+			else if (value is IConvertible)
+				text.Append(Convert.ToString(value, CultureInfo.InvariantCulture));
+			else
+				WriteString(text, value.ToString());
+		}
+
+		private static void WriteString(StringBuilder text, string value)
+		{
+			text.Append('"');
+			foreach (char c in value)
+			{
+				switch (c)
+				{
+					case '"': text.Append("\\\""); break;
+					case '\\': text.Append("\\\\"); break;
+					case '\n': text.Append("\\n"); break;
+					case '\r': text.Append("\\r"); break;
+					case '\t': text.Append("\\t"); break;
+					default:
+						if (c < ' ')
+							text.AppendFormat("\\u{0:x4}", (int)c);
+						else
+							text.Append(c);
+						break;
+				}
+			}
+			text.Append('"');
+		}
+	}
+}
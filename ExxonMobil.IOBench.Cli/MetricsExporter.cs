@@ -0,0 +1,217 @@
+﻿// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using ExxonMobil.IOBench.Core;
+
+namespace ExxonMobil.IOBench.Cli
+{
+	// Exports live benchmark metrics for scripts and monitoring systems. Each Sample() writes one 
+	// JSON line covering the interval since the previous sample and refreshes the Prometheus text 
+	// served on the optional metrics port. The port is unauthenticated, so it only listens on 
+	// loopback unless every interface is asked for. Finish() writes the final summary line.
+	class MetricsExporter : IDisposable
+	{
+		public MetricsExporter(Benchmark benchmark, BenchmarkConfiguration config, TextWriter json, ushort prometheusPort, bool prometheusAllInterfaces)
+		{
+			this.benchmark = benchmark;
+			this.config = config;
+			this.json = json;
+
+			if (prometheusPort != 0)
+			{
+				// A raw listener avoids the URL ACL registration HttpListener needs for non-admin users.
+				listener = new TcpListener(prometheusAllInterfaces ? IPAddress.Any : IPAddress.Loopback, prometheusPort);
+				listener.Start();
+				Task.Factory.StartNew(Serve, TaskCreationOptions.LongRunning);
+			}
+		}
+
+		public void Sample()
+		{
+			double elapsed = clock.Elapsed.TotalSeconds;
+			double seconds = elapsed - lastElapsed;
+			long bytes = benchmark.BytesTransferred;
+			long blocks = benchmark.BlocksTransferred;
+			var latency = benchmark.Latency;
+			var intervalLatency = latency.Since(lastLatency);
+
+			long intervalBytesPerSec = seconds > 0 ? (long)((bytes - lastBytes) / seconds) : 0;
+			long intervalIops = seconds > 0 ? (long)((blocks - lastBlocks) / seconds) : 0;
+
+			if (json != null)
+			{
+				var line = new JsonObject()
+					.Add("type", "interval")
+					.Add("timestamp", DateTime.UtcNow.ToString("o", CultureInfo.InvariantCulture))
+					.Add("elapsed", elapsed)
+					.Add("bytes", bytes)
+					.Add("blocks", blocks)
+					.Add("bytesPerSec", intervalBytesPerSec)
+					.Add("iops", intervalIops)
+					.Add("averageBytesPerSec", benchmark.AverageBytesTransferredPerSec)
+					.Add("inFlight", benchmark.InFlight)
+					.Add("verifyBacklog", benchmark.VerifyBacklog)
+					.Add("latency", LatencyObject(intervalLatency))
+					.Add("cumulativeLatency", LatencyObject(latency));
+				WriteLine(line);
+			}
+
+			if (listener != null)
+			{
+				var text = new StringBuilder();
+				AppendMetric(text, "iobench_bytes_total", "counter", "Bytes transferred.", bytes);
+				AppendMetric(text, "iobench_blocks_total", "counter", "Requests completed.", blocks);
+				AppendMetric(text, "iobench_throughput_bytes_per_second", "gauge", "Throughput over the last interval.", intervalBytesPerSec);
+				AppendMetric(text, "iobench_iops", "gauge", "Requests per second over the last interval.", intervalIops);
+				AppendMetric(text, "iobench_in_flight", "gauge", "Requests outstanding.", benchmark.InFlight);
+				AppendMetric(text, "iobench_verify_backlog", "gauge", "Buffers waiting on a verifier thread.", benchmark.VerifyBacklog);
+				AppendMetric(text, "iobench_errors_total", "counter", "Runs stopped by a failed request.", failed ? 1 : 0);
+				text.Append("# HELP iobench_latency_microseconds Request latency since the start of the run.\n");
+				text.Append("# TYPE iobench_latency_microseconds summary\n");
+				foreach (var q in Quantiles)
+					text.AppendFormat(CultureInfo.InvariantCulture, "iobench_latency_microseconds{{quantile=\"{0}\"}} {1}\n", q, latency.Quantile(q));
+				text.AppendFormat(CultureInfo.InvariantCulture, "iobench_latency_microseconds_sum {0}\n", latency.MeanMicroseconds * latency.Count);
+				text.AppendFormat(CultureInfo.InvariantCulture, "iobench_latency_microseconds_count {0}\n", latency.Count);
+				prometheusText = text.ToString();
+			}
+
+			lastElapsed = elapsed;
+			lastBytes = bytes;
+			lastBlocks = blocks;
+			lastLatency = latency;
+		}
+
+		// Writes the summary line. The error is null for completed or canceled runs.
+		public void Finish(bool canceled, Exception error)
+		{
+			failed = error != null;
+			Sample();
+
+			if (json == null)
+				return;
+
+			var line = new JsonObject()
+				.Add("type", "summary")
+				.Add("timestamp", DateTime.UtcNow.ToString("o", CultureInfo.InvariantCulture))
+				.Add("status", failed ? "failed" : canceled ? "canceled" : "completed")
+				.Add("error", failed ? error.Message : null)
+				.Add("config", JsonObject.FromProperties(config))
+				.Add("results", new JsonObject()
+					.Add("bytes", benchmark.BytesTransferred)
+					.Add("blocks", benchmark.BlocksTransferred)
+					.Add("averageBytesPerSec", benchmark.AverageBytesTransferredPerSec)
+					.Add("transferSeconds", benchmark.TransferTime.TotalSeconds)
+					.Add("wallSeconds", benchmark.WallTime.TotalSeconds)
+					.Add("completedSynchronously", benchmark.CompletedSynchronously)
+					.Add("completedAsynchronously", benchmark.CompletedAsynchronously)
+					.Add("verifiedBytes", benchmark.VerifiedBytes)
+					.Add("trimmedBytes", benchmark.TrimmedBytes)
+					.Add("syscallsPerIO", benchmark.SyscallsPerIO)
+					.Add("cpuMicrosecondsPerIO", benchmark.CpuMicrosecondsPerIO)
+					.Add("latency", LatencyObject(benchmark.Latency)));
+			WriteLine(line);
+		}
+
+		public void Dispose()
+		{
+			if (listener != null)
+			{
+				listener.Stop();
+				listener = null;
+			}
+			if (json != null)
+				json.Flush();
+		}
+
+		private static JsonObject LatencyObject(LatencyHistogram latency)
+		{
+			return new JsonObject()
+				.Add("count", latency.Count)
+				.Add("mean", latency.MeanMicroseconds)
+				.Add("p50", latency.Quantile(0.5))
+				.Add("p90", latency.Quantile(0.9))
+				.Add("p99", latency.Quantile(0.99))
+				.Add("p999", latency.Quantile(0.999));
+		}
+
+		private static void AppendMetric(StringBuilder text, string name, string type, string help, long value)
+		{
+			text.AppendFormat(CultureInfo.InvariantCulture, "# HELP {0} {1}\n# TYPE {0} {2}\n{0} {3}\n", name, help, type, value);
+		}
+
+		private void WriteLine(JsonObject line)
+		{
+			json.WriteLine(line.ToString());
+			json.Flush();
+		}
+
+		// Answers every connection with the latest exposition text, whatever the request path.
+		private void Serve()
+		{
+			var current = listener;
+			while (true)
+			{
+				TcpClient client;
+				try { client = current.AcceptTcpClient(); }
+				catch (SocketException) { return; }
+				catch (ObjectDisposedException) { return; }
+				catch (InvalidOperationException) { return; }
+
+				using (client)
+				{
+					try
+					{
+						var stream = client.GetStream();
+						stream.ReadTimeout = 2000;
+						var request = new byte[4096];
+						stream.Read(request, 0, request.Length);
+
+						var body = Encoding.UTF8.GetBytes(prometheusText ?? String.Empty);
+						var header = Encoding.ASCII.GetBytes(
+							"HTTP/1.0 200 OK\r\n" +
+							"Content-Type: text/plain; version=0.0.4\r\n" +
+							"Content-Length: " + body.Length.ToString(CultureInfo.InvariantCulture) + "\r\n" +
+							"Connection: close\r\n\r\n");
+						stream.Write(header, 0, header.Length);
+						stream.Write(body, 0, body.Length);
+					}
+					catch (IOException) { }
+				}
+			}
+		}
+
+		private static readonly double[] Quantiles = { 0.5, 0.9, 0.99, 0.999 };
+
+		private readonly Benchmark benchmark;
+		private readonly BenchmarkConfiguration config;
+		private readonly TextWriter json;
+		private readonly Stopwatch clock = Stopwatch.StartNew();
+		private TcpListener listener;
+		private volatile string prometheusText;
+		private bool failed;
+		private double lastElapsed;
+		private long lastBytes;
+		private long lastBlocks;
+		private LatencyHistogram lastLatency = new LatencyHistogram();
+	}
+}
@@ -23,6 +23,8 @@ using System.IO;
 using System.Reflection;
 using ExxonMobil.Shared.Cli;
 using System.Net;
+using System.Globalization;
+using System.Text.RegularExpressions;
 
 namespace ExxonMobil.IOBench.Cli
 {
@@ -43,13 +45,22 @@ namespace ExxonMobil.IOBench.Cli
 
 			try
 			{
-				Console.WriteLine();
-				Console.WriteLine(GetHeadline());
-				Console.WriteLine();
-
 				ConsoleArguments arguments;
 				try { arguments = new ConsoleArguments(); }
 				catch (ArgumentException e) { throw new IOBenchCliException("Argument parsing issue.", e) { HelpText = e.Message }; }
+
+				// JSON lines written to stdout must not be mixed with anything else. Everything 
+				// meant for a person goes to stderr instead.
+				string jsonPath;
+				if (arguments.Named.TryGetValue(JsonOption, out jsonPath) && String.IsNullOrWhiteSpace(jsonPath))
+				{
+					jsonWriter = Console.Out;
+					Console.SetOut(Console.Error);
+				}
+
+				Console.WriteLine();
+				Console.WriteLine(GetHeadline());
+				Console.WriteLine();
 				
 				if (arguments.NoArguments)
 				{
@@ -59,10 +70,12 @@ namespace ExxonMobil.IOBench.Cli
 
 				if (arguments.Named.ContainsKey(NetworkAnalysisOnlyOption))
 					RunNetworkAnalysisOnly(arguments);
+				else if (arguments.Named.ContainsKey(JobGroupsOption))
+					RunJobGroups(arguments);
 				else
 					RunBenchmark(arguments);
 
-				return 0;
+				return regressionDetected ? RegressionExitCode : 0;
 			}
 			catch (AggregateException e)
 			{
@@ -121,6 +134,347 @@ namespace ExxonMobil.IOBench.Cli
 		}
 
 		const string NetworkAnalysisOnlyOption = "nao";
+		const string JsonOption = "json";
+
+		// Options a coordinator keeps to itself rather than passing on to the workers it spawns.
+		static readonly string[] CoordinatorOptions = { "coord", "port", "spawn", "rf", JsonOption, "prom", "promall", "na" };
+
+		const string JobGroupsOption = "groups";
+		const string ProtectOption = "protect";
+
+		// The only options of a job group run given on the command line, and the options that 
+		// apply to a whole run and so can not be given to a single group.
+		static readonly string[] JobGroupRunOptions = { JobGroupsOption, ProtectOption, "rf" };
+		static readonly string[] ProcessOptions = { "coord", "port", "spawn", "worker", "rf", JsonOption, "prom", "promall", "interval", "na", 
+			NetworkAnalysisOnlyOption, JobGroupsOption, ProtectOption, "repeat", "baseline", "basetag" };
+		static readonly Regex JobGroupName = new Regex(@"^\w+$");
+
+		private static void RunJobGroups(ConsoleArguments arguments)
+		{
+			if (arguments.Anonymous.Count > 0 || arguments.Named.Keys.Any(k => !JobGroupRunOptions.Contains(k)))
+				throw new IOBenchCliException("Job groups only take -groups, -protect and -rf on the command line.")
+				{
+					HelpText = "Every other option and the file path of a group go on its line of the group file."
+				};
+
+			var groups = LoadJobGroups(arguments.Named[JobGroupsOption]);
+			string protect;
+			if (arguments.Named.TryGetValue(ProtectOption, out protect))
+			{
+				var protectedGroup = groups.FirstOrDefault(g => String.Equals(g.Name, protect, StringComparison.OrdinalIgnoreCase));
+				if (protectedGroup == null)
+					throw new IOBenchCliException("No job group to protect named: " + protect);
+				protectedGroup.Protected = true;
+			}
+			string resultPath;
+			if (arguments.Named.TryGetValue("rf", out resultPath))
+				resultFilePath = resultPath;
+
+			bool valid = true;
+			foreach (var group in groups)
+			{
+				if (!group.Config.Validate(logger))
+				{
+					logger.Log("Job group '" + group.Name + "' is not valid.", Category.Exception);
+					valid = false;
+				}
+			}
+			if (!valid)
+				return;
+
+			// Groups opening the same target would lock each other out once any of them writes.
+			var shared = groups.Where(g => !g.Config.IsEmulated)
+				.GroupBy(g => g.Config.FilePath, StringComparer.OrdinalIgnoreCase)
+				.FirstOrDefault(t => t.Count() > 1 && t.Any(g => !g.Config.IsRead));
+			if (shared != null)
+				throw new IOBenchCliException("Job groups " + String.Join(", ", shared.Select(g => g.Name)) + " all use '" + shared.Key + "'.")
+				{
+					HelpText = "Only groups that read may share a file. Give every group that writes a file of its own."
+				};
+
+			var run = new JobGroupRun(groups);
+			var cts = new CancellationTokenSource();
+			Console.CancelKeyPress += (s, e) => { cts.Cancel(); e.Cancel = true; };
+
+			var runTask = run.Start(cts.Token);
+			while (!runTask.IsCompleted)
+			{
+				Console.Write("\r" + JobGroupProgress(run).PadRight(TransferDisplayWidth - 1));
+				Thread.Sleep(500);
+			}
+			Console.WriteLine();
+			Console.WriteLine();
+
+			if (runTask.IsFaulted)
+				throw runTask.Exception;
+
+			if (runTask.IsCanceled)
+			{
+				logger.Log("Benchmark canceled by user.", Category.Exception);
+				return;
+			}
+
+			PrintJobGroupSummary(run);
+
+			if (resultFilePath != null)
+			{
+				foreach (var group in groups)
+					WriteResults(group.Mixed, group.Config);
+			}
+		}
+
+		// Reads a group file. Every line that is not blank or a # comment holds a group name 
+		// followed by the options and path of that group, as they would be given on the command 
+		// line. Double quotes keep a path with spaces together.
+		private static List<JobGroup> LoadJobGroups(string path)
+		{
+			if (String.IsNullOrWhiteSpace(path) || !File.Exists(path))
+				throw new IOBenchCliException("Job group file not found: " + path);
+
+			var groups = new List<JobGroup>();
+			foreach (var line in File.ReadAllLines(path).Select(l => l.Trim()))
+			{
+				if (line.Length == 0 || line.StartsWith("#"))
+					continue;
+
+				var tokens = Regex.Matches(line, "\"([^\"]*)\"|(\\S+)").Cast<Match>()
+					.Select(m => m.Groups[1].Success ? m.Groups[1].Value : m.Groups[2].Value)
+					.ToList();
+				var name = tokens[0];
+				if (!JobGroupName.IsMatch(name))
+					throw new IOBenchCliException("Invalid job group name: " + name);
+				if (groups.Any(g => String.Equals(g.Name, name, StringComparison.OrdinalIgnoreCase)))
+					throw new IOBenchCliException("Job group named more than once: " + name);
+
+				ConsoleArguments args;
+				try { args = new ConsoleArguments(tokens.Skip(1)); }
+				catch (ArgumentException e) { throw new IOBenchCliException("Argument parsing issue in job group " + name + ".", e) { HelpText = e.Message }; }
+				var processOption = args.Named.Keys.FirstOrDefault(k => ProcessOptions.Contains(k));
+				if (processOption != null)
+					throw new IOBenchCliException("-" + processOption + " applies to a whole run and can not be given to job group " + name + ".");
+
+				var config = ProcessBenchmarkArgs(args);
+				if (!args.Named.ContainsKey("tag"))
+					config.Name = name;
+				groups.Add(new JobGroup(name, config));
+			}
+
+			if (groups.Count < 2)
+				throw new IOBenchCliException("A group file needs at least two job groups.");
+			return groups;
+		}
+
+		private static string JobGroupProgress(JobGroupRun run)
+		{
+			if (run.Phase == JobGroupPhase.Baseline)
+			{
+				var baseline = run.ProtectedGroup.Baseline;
+				return String.Format("Baseline: {0} {1:p0}", run.ProtectedGroup.Name, baseline == null ? 0 : baseline.PercentComplete);
+			}
+			if (run.Phase == JobGroupPhase.Mixed)
+			{
+				return "Mixed: " + String.Join("  ", run.Groups.Select(g => 
+					String.Format("{0} {1:p0}", g.Name, g.Mixed == null ? 0 : g.Mixed.PercentComplete)));
+			}
+			return "Starting";
+		}
+
+		// Runs the benchmark repeatCount times without the live panel, writing a results row for 
+		// every repetition. Conditioning is only done ahead of the first. The baseline is read 
+		// before any row is written, so a baseline that is also the results file never holds 
+		// the runs it judges. It is matched once the first benchmark has resolved the block 
+		// size and buffering of a device or trace.
+		private static void RunRepeated(BenchmarkConfiguration config)
+		{
+			Dictionary<string, SampleStatistics> baseline = null;
+			var runs = new List<Benchmark>();
+			var cts = new CancellationTokenSource();
+			Console.CancelKeyPress += (s, e) => { cts.Cancel(); e.Cancel = true; };
+
+			for (int i = 0; i < repeatCount && !cts.IsCancellationRequested; i++)
+			{
+				var benchmark = Benchmark.Create(config);
+				if (i == 0 && baselinePath != null)
+					baseline = LoadBaseline(baselinePath, config);
+				var benchmarkTask = benchmark.Start(cts.Token);
+				while (!benchmarkTask.IsCompleted)
+				{
+					Console.Write("\r" + String.Format("Repetition {0}/{1}: {2:p0}", i + 1, repeatCount, benchmark.PercentComplete)
+						.PadRight(TransferDisplayWidth - 1));
+					Thread.Sleep(500);
+				}
+
+				if (benchmarkTask.IsFaulted)
+				{
+					Console.WriteLine();
+					throw benchmarkTask.Exception;
+				}
+				if (benchmarkTask.IsCanceled)
+					break;
+
+				runs.Add(benchmark);
+				if (resultFilePath != null)
+					WriteResults(benchmark, config, (i + 1) + "/" + repeatCount);
+
+				// A raw device holds no marker to skip conditioning by, so it is turned off instead.
+				config.RepeatPrecondition = false;
+				if (config.IsDevice)
+				{
+					config.PreconditionPasses = 0;
+					config.PreconditionRounds = 0;
+				}
+			}
+			Console.WriteLine();
+			Console.WriteLine();
+
+			if (cts.IsCancellationRequested)
+			{
+				logger.Log("Benchmark canceled by user.", Category.Exception);
+				return;
+			}
+
+			var current = RepeatMetrics.ToDictionary(m => m.Label, m => new SampleStatistics(runs.Select(m.Measure)));
+			PrintRepeatSummary(current);
+			if (baseline != null)
+				CompareWithBaseline(current, baseline);
+		}
+
+		private static void PrintRepeatSummary(Dictionary<string, SampleStatistics> current)
+		{
+			Console.WriteLine("Repetitions ({0} runs, 95% confidence interval)", current.Values.First().Count);
+			Console.WriteLine("{0,-12}{1,12}{2,12}{3,26}", "", "Mean", "StdDev", "95% CI");
+			foreach (var metric in RepeatMetrics)
+			{
+				var stats = current[metric.Label];
+				Console.WriteLine("{0,-12}{1,12:0.0}{2,12:0.0}{3,26}", metric.Label + ":", stats.Mean, stats.StdDev, 
+					String.Format("{0:0.0} - {1:0.0}", stats.Mean - stats.ConfidenceHalfWidth95, stats.Mean + stats.ConfidenceHalfWidth95));
+			}
+			Console.WriteLine();
+		}
+
+		// A regression is a change for the worse that Welch's test finds significant at 95%. 
+		// Changes within the noise of either set of runs are not reported as either.
+		private static void CompareWithBaseline(Dictionary<string, SampleStatistics> current, Dictionary<string, SampleStatistics> baseline)
+		{
+			var baselineRuns = baseline.Values.First().Count;
+			Console.WriteLine("Baseline ({0} runs from {1})", baselineRuns, Path.GetFileName(baselinePath));
+			Console.WriteLine("{0,-12}{1,12}{2,12}{3,10}  {4}", "", "Baseline", "Current", "Change", "Result");
+			var regressions = new List<string>();
+			foreach (var metric in RepeatMetrics)
+			{
+				var before = baseline[metric.Label];
+				var after = current[metric.Label];
+				var result = "No significant change";
+				if (SampleStatistics.DiffersSignificantly(before, after))
+				{
+					bool better = metric.HigherIsBetter ? after.Mean > before.Mean : after.Mean < before.Mean;
+					result = better ? "Improvement" : "Regression";
+					if (!better)
+						regressions.Add(metric.Label);
+				}
+				Console.WriteLine("{0,-12}{1,12:0.0}{2,12:0.0}{3,10}  {4}", metric.Label + ":", before.Mean, after.Mean, 
+					Delta(before.Mean, after.Mean), result);
+			}
+			Console.WriteLine();
+
+			if (regressions.Count > 0)
+			{
+				regressionDetected = true;
+				logger.Log("Significant regression against the baseline in " + String.Join(", ", regressions) + ".", Category.Exception);
+			}
+		}
+
+		// Rows of a results file for the same workload as config, by the column names of its 
+		// header. A file written before the Goodput column existed can not serve as a baseline, 
+		// and neither can one with fewer than two matching rows.
+		private static Dictionary<string, SampleStatistics> LoadBaseline(string path, BenchmarkConfiguration config)
+		{
+			if (!File.Exists(path))
+				throw new IOBenchCliException("Baseline file not found: " + path);
+
+			var lines = File.ReadAllLines(path);
+			var header = lines.Length == 0 ? new string[0] : lines[0].Split('\t');
+			var columns = new[] { "Tag", "Access Pattern", "Operation", "Blocks", "BlockSizeKB", "AsyncMax", "Asynch", "NoBuffering" }
+				.Concat(RepeatMetrics.Select(m => m.Column))
+				.ToDictionary(c => c, c => Array.IndexOf(header, c));
+			var missing = columns.FirstOrDefault(c => c.Value < 0);
+			if (missing.Key != null)
+				throw new IOBenchCliException("The baseline file has no '" + missing.Key + "' column: " + path);
+
+			var rows = lines.Skip(1)
+				.Select(l => l.Split('\t'))
+				.Where(f => f.Length == header.Length &&
+					f[columns["Access Pattern"]] == config.AccessPattern.ToString() &&
+					f[columns["Operation"]] == config.Operation.ToString() &&
+					f[columns["Blocks"]] == config.Blocks.ToString() &&
+					f[columns["BlockSizeKB"]] == (config.BlockSizeBytes / 1024).ToString() &&
+					f[columns["AsyncMax"]] == config.AsyncMaxBlocksOutstanding.ToString() &&
+					f[columns["Asynch"]] == AsynchMode(config) &&
+					f[columns["NoBuffering"]] == BufferingMode(config) &&
+					(baselineTag == null || String.Equals(f[columns["Tag"]], baselineTag, StringComparison.OrdinalIgnoreCase)))
+				.ToList();
+			if (rows.Count < 2)
+				throw new IOBenchCliException("The baseline file holds " + rows.Count + " matching run(s). At least 2 are needed.")
+				{
+					HelpText = "Rows match on access pattern, operation, block count, block size, queue depth, asynchronous and " +
+						"buffering mode, and on the tag given with -basetag. Record a baseline with -repeat and -rf."
+				};
+
+			return RepeatMetrics.ToDictionary(m => m.Label, m => new SampleStatistics(rows.Select(f =>
+			{
+				double value;
+				if (!double.TryParse(f[columns[m.Column]], out value))
+					throw new IOBenchCliException("Invalid '" + m.Column + "' value in the baseline file: " + f[columns[m.Column]]);
+				return value;
+			})));
+		}
+
+		// Measurements compared across repetitions and the results file column each is read back 
+		// from.
+		private class RepeatMetric
+		{
+			public string Label;
+			public string Column;
+			public bool HigherIsBetter;
+			public Func<Benchmark, double> Measure;
+		}
+
+		static readonly RepeatMetric[] RepeatMetrics =
+		{
+			new RepeatMetric { Label = "MiB/s", Column = "Goodput MiB/s", HigherIsBetter = true, Measure = b => GoodputMiBPerSec(b) },
+			new RepeatMetric { Label = "Mean us", Column = "Latency Mean us", Measure = b => b.Latency.MeanMicroseconds },
+			new RepeatMetric { Label = "p50 us", Column = "Latency p50 us", Measure = b => b.Latency.Quantile(0.5) },
+			new RepeatMetric { Label = "p99 us", Column = "Latency p99 us", Measure = b => b.Latency.Quantile(0.99) },
+			new RepeatMetric { Label = "p99.9 us", Column = "Latency p99.9 us", Measure = b => b.Latency.Quantile(0.999) }
+		};
+
+		// The Asynch and NoBuffering columns of a results row.
+		private static string AsynchMode(BenchmarkConfiguration config)
+		{
+			return config.Asynchronous ? (config.StrictAsync ? "StrictAsync" : "Async") : "Sync";
+		}
+
+		private static string BufferingMode(BenchmarkConfiguration config)
+		{
+			return config.NoBuffering ? "NoBuffering" : "Buffering";
+		}
+
+		private static double GoodputMiBPerSec(Benchmark benchmark)
+		{
+			return (double)benchmark.AverageBytesTransferredPerSec / (1024 * 1024);
+		}
+
+		private static List<string> GetWorkerArguments()
+		{
+			var named = new Regex(@"^-(\w*)");
+			return Environment.GetCommandLineArgs().Skip(1)
+				.Where(a =>
+				{
+					var match = named.Match(a);
+					return match.Success && !CoordinatorOptions.Contains(match.Groups[1].Value.ToLower());
+				})
+				.ToList();
+		}
 
 		private static void RunBenchmark(ConsoleArguments arguments)
 		{
@@ -130,6 +484,19 @@ namespace ExxonMobil.IOBench.Cli
 			if (!config.Validate(logger))
 				return;
 
+			if (coordinatedWorkers > 0)
+			{
+				var coordinator = new Coordinator(coordinatedWorkers, coordinatorPort, spawnWorkers, logger);
+				coordinator.Run(config, GetWorkerArguments(), arguments.Anonymous.FirstOrDefault(), metricsInterval);
+				return;
+			}
+
+			if (repeatCount > 1)
+			{
+				RunRepeated(config);
+				return;
+			}
+
 			var networkAnalysis = enableNetworkAnalysis ? new NetworkAnalysis(logger) : null;
 			var benchmark = Benchmark.Create(config);
 			if (enableNetworkAnalysis)
@@ -138,28 +505,57 @@ namespace ExxonMobil.IOBench.Cli
 			var cts = new CancellationTokenSource();
 			Console.CancelKeyPress += (s, e) => { cts.Cancel(); e.Cancel = true; };
 
+			if (workerEndpoint != null)
+			{
+				CoordinatedWorker.Run(benchmark, workerEndpoint, cts, metricsInterval);
+				return;
+			}
+
+			if (jsonFilePath != null)
+				jsonWriter = new StreamWriter(jsonFilePath, true);
+			var exporter = jsonWriter != null || prometheusPort != 0 ? new MetricsExporter(benchmark, config, jsonWriter, prometheusPort, prometheusAllInterfaces) : null;
+
 			var benchmarkTask = benchmark.Start(cts.Token);
 
-			InitDisplay();
-            try
-            {
-                while (!benchmarkTask.IsCompleted)
-                {
-                    UpdateBenchmarkDisplay(benchmark);
-                    if (enableNetworkAnalysis)
-                        UpdateNetworkAnalysisDisplay(networkAnalysis);
+			// Headless runs have no panel and sample once per interval.
+			if (jsonWriter != null)
+			{
+				while (Task.WaitAny(new Task[] { benchmarkTask }, metricsInterval) < 0)
+					exporter.Sample();
+			}
+			else
+			{
+				InitDisplay();
+				try
+				{
+					while (!benchmarkTask.IsCompleted)
+					{
+						UpdateBenchmarkDisplay(benchmark);
+						if (enableNetworkAnalysis)
+							UpdateNetworkAnalysisDisplay(networkAnalysis);
+						if (exporter != null)
+							exporter.Sample();
 
-                    ResetDisplay();
-                    Thread.Sleep(500);
-                }
-                UpdateBenchmarkDisplay(benchmark);
-                if (enableNetworkAnalysis)
-                    UpdateNetworkAnalysisDisplay(networkAnalysis);
-            }
-            finally
-            {
-                EndDisplay();
-            }
+						ResetDisplay();
+						Thread.Sleep(500);
+					}
+					UpdateBenchmarkDisplay(benchmark);
+					if (enableNetworkAnalysis)
+						UpdateNetworkAnalysisDisplay(networkAnalysis);
+				}
+				finally
+				{
+					EndDisplay();
+				}
+			}
+
+			if (exporter != null)
+			{
+				exporter.Finish(benchmarkTask.IsCanceled, benchmarkTask.IsFaulted ? benchmarkTask.Exception.GetBaseException() : null);
+				exporter.Dispose();
+			}
+			if (jsonFilePath != null)
+				jsonWriter.Dispose();
 
 			if (enableNetworkAnalysis)
 				networkAnalysis.Stop();
@@ -173,6 +569,33 @@ namespace ExxonMobil.IOBench.Cli
 				return;
 			}
 
+			if (config.StrictAsync && benchmark.CompletedSynchronously > 0)
+				logger.Log(String.Format("{0} of {1} requests completed synchronously in strict asynchronous mode.", 
+					benchmark.CompletedSynchronously, benchmark.BlocksTransferred), Category.Warn);
+
+			if (config.IsDevice)
+				PrintDeviceSummary((FileBenchmark)benchmark);
+			if (config.IsPreconditioned)
+				PrintPreconditionSummary((FileBenchmark)benchmark);
+
+			if (config.IsReplay)
+				PrintReplaySummary(benchmark, config);
+			else if (config.IsMetadata)
+				PrintMetadataSummary((MetadataBenchmark)benchmark);
+			else if (config.IsLog)
+				PrintLogSummary((FileBenchmark)benchmark, config);
+			else if (benchmark.BlocksTransferred > 0)
+			{
+				if (!config.IsTrim)
+					PrintLatencySummary(benchmark, config);
+				if (config.IsTrim || config.TrimPercent > 0)
+					PrintTrimSummary(benchmark, config);
+				if (config.IsSharedFile)
+					PrintSharedSummary((FileBenchmark)benchmark, config);
+				if (config.IsMultiStream)
+					PrintStreamSummary((FileBenchmark)benchmark, config);
+			}
+
 			if (resultFilePath != null)
 				WriteResults(benchmark, config);
 		}
@@ -186,8 +609,13 @@ namespace ExxonMobil.IOBench.Cli
 			Console.SetCursorPosition(0, CursorYOrigin);
 		}
 
-		private static void WriteResults(Benchmark benchmark, BenchmarkConfiguration config)
+		private static void WriteResults(Benchmark benchmark, BenchmarkConfiguration config, string repetition = null)
 		{
+			var latency = benchmark.Latency;
+			var trimLatency = benchmark.TrimLatency;
+			var fileBenchmark = benchmark as FileBenchmark;
+			var sharers = fileBenchmark == null ? null : fileBenchmark.SharerBytesPerSec;
+			var streams = fileBenchmark == null ? null : fileBenchmark.StreamBytesPerSec;
 			var info = new FileInfo(resultFilePath);
 			bool writeHeader = false;
 			TextWriter writer;
@@ -206,9 +634,21 @@ namespace ExxonMobil.IOBench.Cli
 			{
 				if (writeHeader)
 					writer.WriteLine("Tag\tAccess Pattern\tOperation\tMulti-file\tBlocks\tBlockSizeKB\tAsyncMax\tReadVerified\tAsynch\tNoBuffering\tWriteThrough\tDisableLocalBuffering\tPreallocated\t" +
-						             "ReadWriteFile Time\tWait CompPort Time\tTransfer Wall Time\tCreateFile Time\tPreallocation Time");
+						             "ReadWriteFile Time\tWait CompPort Time\tTransfer Wall Time\tCreateFile Time\tPreallocation Time\t" +
+						             "CPU User Time\tCPU Kernel Time\tCPU Cycles\tContext Switches\tCPU us per IO\tCPU s per GB\t" +
+						             "SubmitBatch\tSubmit Calls\tCompletion Calls\tSyscalls per IO\t" +
+						             "Completion Mode\tLatency Mean us\tLatency p50 us\tLatency p99 us\tLatency p99.9 us\tPlacement\t" +
+						             "Metadata Tree\tmkdir/s\tcreate/s\tstat/s\topen/s\trename/s\tunlink/s\trmdir/s\t" +
+						             "Trim Type\tTrim Mix %\tTrimmed Bytes\tTrim p50 us\tTrim p99 us\tPre-trim Write p99 us\tPost-trim Write p99 us\t" +
+						             "Verify Threads\tVerified Bytes\tVerify Time\tVerify Backlog Peak\t" +
+						             "Cache State\tCache Primed Bytes\tSystem Cache Before\tSystem Cache After\t" +
+						             "Shared File\tSlowest Sharer MiB/s\t" +
+						             "Log Records\tCommits/s\tAvg Group Records\t" +
+						             "Precondition\tDevice\tIO Priority\tRate MiB/s\t" +
+						             "Goodput MiB/s\tRepetition\tScatter/Gather\t" +
+						             "Streams\tSlowest Stream MiB/s\tFastest Stream MiB/s");
 
-				writer.WriteLine("{0}\t{1}\t{2}\t{3}\t{4}\t{5}\t{6}\t{7}\t{8}\t{9}\t{10}\t{11}\t{12}\t{13}\t{14}\t{15}\t{16}\t{17}",
+				writer.WriteLine("{0}\t{1}\t{2}\t{3}\t{4}\t{5}\t{6}\t{7}\t{8}\t{9}\t{10}\t{11}\t{12}\t{13}\t{14}\t{15}\t{16}\t{17}\t{18}\t{19}\t{20}\t{21}\t{22}\t{23}\t{24}\t{25}\t{26}\t{27}\t{28}\t{29}\t{30}\t{31}\t{32}\t{33}\t{34}\t{35}\t{36}\t{37}\t{38}\t{39}\t{40}\t{41}\t{42}\t{43}\t{44}\t{45}\t{46}\t{47}\t{48}\t{49}\t{50}\t{51}\t{52}\t{53}\t{54}\t{55}\t{56}\t{57}\t{58}\t{59}\t{60}\t{61}\t{62}\t{63}\t{64}\t{65}\t{66}\t{67}\t{68}\t{69}\t{70}\t{71}",
 					config.Name.Replace('\t', ' '),
 					config.AccessPattern,
 					config.Operation,
@@ -217,8 +657,8 @@ namespace ExxonMobil.IOBench.Cli
 					config.BlockSizeBytes / 1024,
 					config.AsyncMaxBlocksOutstanding,
 					config.IsRead ? (config.ReadVerify ? "Verified":"Unverified") : "N/A",
-					config.Asynchronous ? "Async":"Sync",
-					config.NoBuffering ? "NoBuffering" : "Buffering",
+					AsynchMode(config),
+					BufferingMode(config),
 					config.WriteThrough ? "WriteThrough" : "NoWriteThrough",
 					config.DisableLocalBuffering ? "DisableLocalBuffering" : "N/A",
 					config.IsWrite ? (config.Preallocation != PreallocationType.None).ToString() : "N/A",
@@ -226,8 +666,343 @@ namespace ExxonMobil.IOBench.Cli
 					benchmark.QueryCompletionPortTime.TotalMilliseconds,
 					benchmark.TransferTime.TotalMilliseconds,
 					benchmark.CreateFileTime.TotalMilliseconds,
-					benchmark.PreallocationTime.TotalMilliseconds);
+					benchmark.PreallocationTime.TotalMilliseconds,
+					benchmark.TransferCpuUsage.UserTime.TotalMilliseconds,
+					benchmark.TransferCpuUsage.KernelTime.TotalMilliseconds,
+					benchmark.TransferCpuUsage.Cycles,
+					benchmark.TransferCpuUsage.ContextSwitches,
+					benchmark.CpuMicrosecondsPerIO,
+					benchmark.CpuSecondsPerGB,
+					config.AdaptiveSubmitBatch ? "Adaptive" : config.SubmitBatch.ToString(),
+					benchmark.SubmitCalls,
+					benchmark.CompletionCalls,
+					benchmark.SyscallsPerIO,
+					config.Asynchronous ? config.CompletionMode.ToString() : "N/A",
+					latency.MeanMicroseconds,
+					latency.Quantile(0.5),
+					latency.Quantile(0.99),
+					latency.Quantile(0.999),
+					benchmark.Placement ?? "None",
+					config.IsMetadata ? String.Format("{0}x{1}x{2}/{3}T/{4}B", config.MetadataDepth, config.MetadataFanout, 
+						config.MetadataFilesPerDirectory, config.MetadataThreads, config.MetadataPayloadBytes) : "N/A",
+					MetadataRate(benchmark, "mkdir"),
+					MetadataRate(benchmark, "create"),
+					MetadataRate(benchmark, "stat"),
+					MetadataRate(benchmark, "open"),
+					MetadataRate(benchmark, "rename"),
+					MetadataRate(benchmark, "unlink"),
+					MetadataRate(benchmark, "rmdir"),
+					config.IsTrim || config.TrimPercent > 0 ? config.TrimType.ToString() : "N/A",
+					config.TrimPercent,
+					benchmark.TrimmedBytes,
+					trimLatency.Quantile(0.5),
+					trimLatency.Quantile(0.99),
+					benchmark.WriteLatencyBeforeTrim == null ? "N/A" : benchmark.WriteLatencyBeforeTrim.Quantile(0.99).ToString(),
+					benchmark.WriteLatencyAfterTrim == null ? "N/A" : benchmark.WriteLatencyAfterTrim.Quantile(0.99).ToString(),
+					config.IsRead && config.ReadVerify && config.Asynchronous ? config.VerifyThreads.ToString() : "N/A",
+					benchmark.VerifiedBytes,
+					benchmark.VerifyTime.TotalMilliseconds,
+					benchmark.VerifyBacklogPeak,
+					config.CacheState == CacheState.Partial ? config.CachePrimePercent + "%" : config.CacheState.ToString(),
+					benchmark.CachePrimedBytes,
+					benchmark.SystemCacheBytesBefore,
+					benchmark.SystemCacheBytesAfter,
+					config.IsSharedFile ? config.Sharers + "x" + SharedFileDescription(config).Replace(", ", "/") : "N/A",
+					sharers == null ? "N/A" : ((double)sharers.Min() / (1024 * 1024)).ToString("0.0"),
+					config.IsLog ? String.Format("{0}P/{1}/{2}us", config.WalProducers, RecordSizeDescription(config), config.WalCommitMicroseconds) : "N/A",
+					config.IsLog ? fileBenchmark.LogCommitsPerSec.ToString("0.0") : "N/A",
+					config.IsLog ? fileBenchmark.LogAverageGroupRecords.ToString("0.00") : "N/A",
+					PreconditionColumn(fileBenchmark),
+					DeviceColumn(fileBenchmark),
+					config.IoPriority.HasValue ? config.IoPriority.Value.ToString() : "Default",
+					config.RateBytesPerSec == 0 ? "N/A" : (config.RateBytesPerSec / (1024 * 1024)).ToString(),
+					GoodputMiBPerSec(benchmark).ToString("0.00"),
+					repetition ?? "N/A",
+					config.ScatterGather ? String.Format("{0}x{1}KB/{2}", config.BlockSizeBytes / Environment.SystemPageSize, 
+						Environment.SystemPageSize / 1024, config.SegmentLayout) : "N/A",
+					config.IsMultiStream ? config.Streams + "x" + StreamDescription(config).Replace(", ", "/") : "N/A",
+					streams == null ? "N/A" : ((double)streams.Min() / (1024 * 1024)).ToString("0.0"),
+					streams == null ? "N/A" : ((double)streams.Max() / (1024 * 1024)).ToString("0.0"));
+			}
+		}
+
+		private static string PreconditionColumn(FileBenchmark benchmark)
+		{
+			if (benchmark == null || benchmark.PreconditionState == null)
+				return "N/A";
+			var state = benchmark.PreconditionState;
+			var column = String.Format("{0}S/{1}R{2}", state.SequentialPasses, state.RandomRounds, state.Steady ? "/Steady" : "");
+			return benchmark.PreconditionSkipped ? column + "/Skipped" : column;
+		}
+
+		private static string DeviceColumn(FileBenchmark benchmark)
+		{
+			if (benchmark == null || benchmark.TargetDevice == null)
+				return "N/A";
+			var device = benchmark.TargetDevice;
+			return String.Format("{0}/{1}/{2}B/{3}", device.BusType, device.Rotational == true ? "HDD" : device.Rotational == false ? "SSD" : "Unknown",
+				device.PhysicalSectorBytes, device.CommandQueueing ? "NCQ" : "NoNCQ");
+		}
+
+		private static string MetadataRate(Benchmark benchmark, string phaseName)
+		{
+			var metadata = benchmark as MetadataBenchmark;
+			if (metadata == null)
+				return "N/A";
+			var phase = metadata.Phases.FirstOrDefault(p => p.Name == phaseName);
+			return phase == null ? "N/A" : phase.OperationsPerSec.ToString("0.0");
+		}
+
+		private static void PrintReplaySummary(Benchmark benchmark, BenchmarkConfiguration config)
+		{
+			var measured = benchmark.Latency;
+			var recorded = benchmark.RecordedLatency;
+			Func<LatencyHistogram, double, string> quantile = (h, q) => h == null ? "N/A" : h.Quantile(q) + " us";
+
+			Console.WriteLine("Replay Latency      Measured         Recorded");
+			Console.WriteLine("Mean:               {0,-16} {1}",
+				String.Format("{0:0.0} us", measured.MeanMicroseconds),
+				recorded == null ? "N/A" : String.Format("{0:0.0} us", recorded.MeanMicroseconds));
+			foreach (var q in new[] { 0.5, 0.9, 0.99, 0.999 })
+				Console.WriteLine("{0,-20}{1,-16} {2}", String.Format("p{0}:", q * 100), quantile(measured, q), quantile(recorded, q));
+			if (config.ReplayTimed && benchmark.BlocksTransferred > 0)
+				Console.WriteLine("Avg Schedule Lag:   {0:0.0} us", benchmark.ScheduleLagTime.TotalMilliseconds * 1000 / benchmark.BlocksTransferred);
+			Console.WriteLine();
+		}
+
+		private static void PrintMetadataSummary(MetadataBenchmark benchmark)
+		{
+			Console.WriteLine("Phase     Ops         Ops/s        Mean         p50          p99");
+			foreach (var phase in benchmark.Phases)
+				Console.WriteLine("{0,-9} {1,-11} {2,-12:0.0} {3,-12} {4,-12} {5}",
+					phase.Name,
+					phase.Operations,
+					phase.OperationsPerSec,
+					String.Format("{0:0.0} us", phase.Latency.MeanMicroseconds),
+					phase.Latency.Quantile(0.5) + " us",
+					phase.Latency.Quantile(0.99) + " us");
+			Console.WriteLine();
+		}
+
+		private static void PrintLatencySummary(Benchmark benchmark, BenchmarkConfiguration config)
+		{
+			var latency = benchmark.Latency;
+
+			Console.WriteLine("Latency ({0})", config.Asynchronous ? config.CompletionMode.ToString() : "Sync");
+			Console.WriteLine("Mean:               {0:0.0} us", latency.MeanMicroseconds);
+			foreach (var q in new[] { 0.5, 0.9, 0.99, 0.999 })
+				Console.WriteLine("{0,-20}{1} us", String.Format("p{0}:", q * 100), latency.Quantile(q));
+			Console.WriteLine("CPU Time/IO:        {0:0.0} us", benchmark.CpuMicrosecondsPerIO);
+			if (config.CacheState != CacheState.Default)
+			{
+				Console.WriteLine(String.Format(DataSizeFormatter.Default, "Cache State:        {0} ({1:FS} primed)", 
+					config.CacheState == CacheState.Partial ? config.CachePrimePercent + "%" : config.CacheState.ToString(), 
+					benchmark.CachePrimedBytes));
+				Console.WriteLine(String.Format(DataSizeFormatter.Default, "System Cache:       {0:FS} before, {1:FS} after",
+					benchmark.SystemCacheBytesBefore, benchmark.SystemCacheBytesAfter));
+			}
+			if (benchmark.Placement != null)
+				Console.WriteLine("Placement:          {0}", benchmark.Placement);
+			Console.WriteLine();
+		}
+
+		private static void PrintTrimSummary(Benchmark benchmark, BenchmarkConfiguration config)
+		{
+			var trim = benchmark.TrimLatency;
+			Console.WriteLine(String.Format(DataSizeFormatter.Default, "Trim Latency ({0}, {1:FS} trimmed)", config.TrimType, benchmark.TrimmedBytes));
+			Console.WriteLine("Mean:               {0:0.0} us", trim.MeanMicroseconds);
+			foreach (var q in new[] { 0.5, 0.9, 0.99, 0.999 })
+				Console.WriteLine("{0,-20}{1} us", String.Format("p{0}:", q * 100), trim.Quantile(q));
+			Console.WriteLine();
+
+			var before = benchmark.WriteLatencyBeforeTrim;
+			var after = benchmark.WriteLatencyAfterTrim;
+			if (before == null || after == null)
+				return;
+			Console.WriteLine("Write Latency       Before Trim      After Trim");
+			Console.WriteLine("Mean:               {0,-16} {1:0.0} us", String.Format("{0:0.0} us", before.MeanMicroseconds), after.MeanMicroseconds);
+			foreach (var q in new[] { 0.5, 0.9, 0.99, 0.999 })
+				Console.WriteLine("{0,-20}{1,-16} {2} us", String.Format("p{0}:", q * 100), before.Quantile(q) + " us", after.Quantile(q));
+			Console.WriteLine();
+		}
+
+		private static void PrintPreconditionSummary(FileBenchmark benchmark)
+		{
+			var state = benchmark.PreconditionState;
+			if (state == null)
+				return;
+
+			if (benchmark.PreconditionSkipped)
+			{
+				Console.WriteLine("Preconditioning:    Skipped, conditioned {0:g} ({1})", state.Time.ToLocalTime(), PreconditionDescription(state));
+				Console.WriteLine();
+				return;
+			}
+
+			Console.WriteLine("Preconditioning:    {0} in {1}", PreconditionDescription(state), benchmark.PreconditionTime);
+			var rates = benchmark.PreconditionRoundBytesPerSec;
+			if (rates.Length > 0)
+				Console.WriteLine("Random Rounds:      {0} MiB/s", String.Join(", ", rates.Select(r => (r / (1024 * 1024)).ToString("0.0"))));
+			if (!benchmark.PreconditionMarkerWritten && benchmark.TargetDevice == null)
+				logger.Log("The file system does not support alternate data streams. Preconditioning will run again next time.", Category.Warn);
+			Console.WriteLine();
+		}
+
+		private static void PrintDeviceSummary(FileBenchmark benchmark)
+		{
+			var device = benchmark.TargetDevice;
+			Console.WriteLine("Device:             {0} ({1}{2})", String.IsNullOrEmpty(device.Model) ? device.Path : device.Model, 
+				device.BusType, device.Removable ? ", Removable" : "");
+			Console.WriteLine(String.Format(DataSizeFormatter.Default, "Size:               {0:FS}, {1} partition(s)", device.SizeBytes, device.Partitions));
+			Console.WriteLine("Sectors:            {0} B logical, {1} B physical{2}", device.LogicalSectorBytes, device.PhysicalSectorBytes,
+				device.AlignmentOffsetBytes == 0 ? "" : String.Format(", first aligned at {0} B", device.AlignmentOffsetBytes));
+			Console.WriteLine("Queueing:           {0}, max transfer {1}, {2}",
+				device.CommandQueueing ? "Command queueing" : "No command queueing",
+				device.MaxTransferBytes == 0 ? "unknown" : String.Format(DataSizeFormatter.Default, "{0:FS}", (long)device.MaxTransferBytes),
+				DeviceMediaDescription(device));
+			Console.WriteLine();
+		}
+
+		private static string DeviceMediaDescription(RawDevice device)
+		{
+			if (!device.Rotational.HasValue)
+				return "media unknown";
+			return device.Rotational.Value ? "rotational" : "non-rotational";
+		}
+
+		private static void PrintJobGroupSummary(JobGroupRun run)
+		{
+			var protectedGroup = run.ProtectedGroup;
+			Console.WriteLine("Job Groups{0}", protectedGroup == null ? "" : " (" + protectedGroup.Name + " protected)");
+			Console.WriteLine("{0,-12}{1,-20}{2,10}{3,10}{4,10}{5,10}{6,10}", "Group", "Workload", "MiB/s", "IOPS", "Mean us", "p50 us", "p99 us");
+			foreach (var group in run.Groups)
+			{
+				var benchmark = group.Mixed;
+				Console.WriteLine("{0,-12}{1,-20}{2,10:0.0}{3,10:0}{4,10:0.0}{5,10}{6,10}", group.Name, JobGroupWorkload(group.Config),
+					(double)benchmark.AverageBytesTransferredPerSec / (1024 * 1024), OperationsPerSec(benchmark),
+					benchmark.Latency.MeanMicroseconds, benchmark.Latency.Quantile(0.5), benchmark.Latency.Quantile(0.99));
 			}
+			Console.WriteLine();
+
+			if (protectedGroup == null)
+				return;
+
+			// Positive deltas are what the other groups cost the protected one.
+			var solo = protectedGroup.Baseline;
+			var mixed = protectedGroup.Mixed;
+			Console.WriteLine("Interference on {0} (solo vs. mixed)", protectedGroup.Name);
+			Console.WriteLine("{0,-20}{1,12:0.0}{2,12:0.0}{3,10}", "MiB/s:", (double)solo.AverageBytesTransferredPerSec / (1024 * 1024),
+				(double)mixed.AverageBytesTransferredPerSec / (1024 * 1024), Delta(solo.AverageBytesTransferredPerSec, mixed.AverageBytesTransferredPerSec));
+			Console.WriteLine("{0,-20}{1,12:0.0}{2,12:0.0}{3,10}", "Mean us:", solo.Latency.MeanMicroseconds, mixed.Latency.MeanMicroseconds,
+				Delta(solo.Latency.MeanMicroseconds, mixed.Latency.MeanMicroseconds));
+			foreach (var q in new[] { 0.5, 0.9, 0.99, 0.999 })
+				Console.WriteLine("{0,-20}{1,12}{2,12}{3,10}", String.Format("p{0} us:", q * 100), solo.Latency.Quantile(q), mixed.Latency.Quantile(q),
+					Delta(solo.Latency.Quantile(q), mixed.Latency.Quantile(q)));
+			Console.WriteLine();
+		}
+
+		private static string JobGroupWorkload(BenchmarkConfiguration config)
+		{
+			var workload = config.AccessPattern + " " + config.Operation;
+			if (config.IoPriority.HasValue)
+				workload += ", " + config.IoPriority.Value;
+			return workload;
+		}
+
+		private static double OperationsPerSec(Benchmark benchmark)
+		{
+			var seconds = benchmark.TransferTime.TotalSeconds;
+			return seconds == 0 ? 0 : benchmark.BlocksTransferred / seconds;
+		}
+
+		private static string Delta(double before, double after)
+		{
+			return before == 0 ? "N/A" : ((after - before) / before).ToString("+0.0%;-0.0%;0.0%");
+		}
+
+		private static string PreconditionDescription(PreconditionMarker state)
+		{
+			var description = state.SequentialPasses + (state.SequentialPasses == 1 ? " sequential pass" : " sequential passes");
+			if (state.RandomRounds > 0)
+				description += String.Format(", {0} random rounds{1}", state.RandomRounds, state.Steady ? " to steady state" : " (not steady)");
+			return description;
+		}
+
+		private static void PrintLogSummary(FileBenchmark benchmark, BenchmarkConfiguration config)
+		{
+			var latency = benchmark.Latency;
+			long written = benchmark.LogRecordBytes + benchmark.LogPaddingBytes;
+
+			Console.WriteLine("Group Commit ({0} producers, {1} records, {2} us interval)", 
+				config.WalProducers, RecordSizeDescription(config), config.WalCommitMicroseconds);
+			Console.WriteLine("Commits:            {0} ({1:0.0}/s)", benchmark.LogCommits, benchmark.LogCommitsPerSec);
+			Console.WriteLine(String.Format(DataSizeFormatter.Default, "Avg Group:          {0:0.0} records, {1:FS} written ({2:0.0}% padding)",
+				benchmark.LogAverageGroupRecords,
+				benchmark.LogCommits == 0 ? 0 : written / benchmark.LogCommits,
+				written == 0 ? 0 : (double)benchmark.LogPaddingBytes * 100 / written));
+			Console.WriteLine("Commit Latency");
+			Console.WriteLine("Mean:               {0:0.0} us", latency.MeanMicroseconds);
+			foreach (var q in new[] { 0.5, 0.9, 0.99, 0.999 })
+				Console.WriteLine("{0,-20}{1} us", String.Format("p{0}:", q * 100), latency.Quantile(q));
+			Console.WriteLine();
+		}
+
+		private static string RecordSizeDescription(BenchmarkConfiguration config)
+		{
+			if (config.WalRecordModel == RecordSizeModel.Fixed)
+				return config.WalRecordBytes + " B";
+			if (config.WalRecordModel == RecordSizeModel.Uniform)
+				return config.WalMinRecordBytes + "-" + config.WalMaxRecordBytes + " B";
+			return "exp " + config.WalRecordBytes + " B mean, " + config.WalMaxRecordBytes + " B max";
+		}
+
+		private static void PrintSharedSummary(FileBenchmark benchmark, BenchmarkConfiguration config)
+		{
+			var sharers = benchmark.SharerBytesPerSec;
+			if (sharers == null)
+				return;
+			Console.WriteLine("Shared File ({0} threads, {1})", config.Sharers, SharedFileDescription(config));
+			Console.WriteLine("Aggregate:          {0:0.0} MiB/s", (double)benchmark.AverageBytesTransferredPerSec / (1024 * 1024));
+			Console.WriteLine("Per Thread:         {0:0.0} min, {1:0.0} mean, {2:0.0} max MiB/s",
+				(double)sharers.Min() / (1024 * 1024), sharers.Average() / (1024 * 1024), (double)sharers.Max() / (1024 * 1024));
+			Console.WriteLine();
+		}
+
+		// Streams whose requests wait far longer than those of a single stream have lost the 
+		// readahead and device prefetch a lone sequential cursor gets. Compare the mean latency 
+		// of runs with different stream counts to see where that happens.
+		private static void PrintStreamSummary(FileBenchmark benchmark, BenchmarkConfiguration config)
+		{
+			var streams = benchmark.StreamBytesPerSec;
+			var latencies = benchmark.StreamLatencyMeanMicroseconds;
+			if (streams == null)
+				return;
+			Console.WriteLine("Streams ({0} streams, {1})", config.Streams, StreamDescription(config));
+			Console.WriteLine("Aggregate:          {0:0.0} MiB/s", (double)benchmark.AverageBytesTransferredPerSec / (1024 * 1024));
+			Console.WriteLine("Per Stream:         {0:0.0} min, {1:0.0} mean, {2:0.0} max MiB/s",
+				(double)streams.Min() / (1024 * 1024), streams.Average() / (1024 * 1024), (double)streams.Max() / (1024 * 1024));
+			Console.WriteLine("Stream Latency:     {0:0.0} min, {1:0.0} mean, {2:0.0} max us",
+				latencies.Min(), latencies.Average(), latencies.Max());
+			if (streams.Length <= 16)
+			{
+				for (int i = 0; i < streams.Length; i++)
+					Console.WriteLine("{0,-20}{1:0.0} MiB/s, {2:0.0} us mean", "Stream " + i + ":", (double)streams[i] / (1024 * 1024), latencies[i]);
+			}
+			Console.WriteLine();
+		}
+
+		private static string StreamDescription(BenchmarkConfiguration config)
+		{
+			var description = config.StreamOrder.ToString();
+			if (config.StreamStride > 1)
+				description += ", Stride " + config.StreamStride;
+			return config.StreamReverse ? description + ", Reverse" : description;
+		}
+
+		private static string SharedFileDescription(BenchmarkConfiguration config)
+		{
+			var description = config.AppendWrites ? "Append" : config.SharedLayout.ToString();
+			return config.LockRanges ? description + ", Locked" : description;
 		}
 
 		private static void HandleException(Exception exception)
@@ -294,7 +1069,7 @@ namespace ExxonMobil.IOBench.Cli
 			Console.CursorVisible = false;
 		}
 
-		private const int TransferDisplayHeight = 7;
+		private const int TransferDisplayHeight = 10;
 		private const int TransferDisplayWidth = 90;
 		private const int NetworkDisplayHeight = 35;
 		private const int NetworkDisplayWidth = 120;
@@ -302,8 +1077,23 @@ namespace ExxonMobil.IOBench.Cli
 		private static int DisplayHeight = -1;
 		private static int DisplayWidth = -1;
 
+		private const int RegressionExitCode = 2;
+
 		private static ILogger logger;
 		private static string resultFilePath;
+		private static string jsonFilePath;
+		private static TextWriter jsonWriter;
+		private static ushort prometheusPort;
+		private static bool prometheusAllInterfaces;
+		private static int metricsInterval = 1000;
+		private static int repeatCount;
+		private static string baselinePath;
+		private static string baselineTag;
+		private static bool regressionDetected;
+		private static int coordinatedWorkers;
+		private static ushort coordinatorPort;
+		private static bool spawnWorkers;
+		private static string workerEndpoint;
 		private static bool enableNetworkAnalysis;
 		private static bool enableTransferDetails;
         private static ushort networkAnalysisLocalPort;
@@ -333,7 +1123,10 @@ namespace ExxonMobil.IOBench.Cli
 				"Wait CompPort Time: {1,-16}   Completed Sync:  {6}\n" +
 				"Transfer Wall Time: {2,-16}   Avg Goodput:     {7:0.0 'MiB/s'} ({8,-15:0.0 'Mbit/s)'}\n" +
 				"CreateFile Time:    {3,-16}   Instant Goodput: {9}\n" +
-				"Preallocation Time: {4,-16} \n",
+				"Preallocation Time: {4,-16}   Syscalls/IO:     {15:0.00}\n" +
+				"CPU User Time:      {10,-16}   CPU Time/IO:     {12:0.0 'us'} ({13:0 'cycles)'}\n" +
+				"CPU Kernel Time:    {11,-16}   Context Switch:  {14}\n" +
+				"Verify Time:        {16,-16}   Verify Goodput:  {17:0.0 'MiB/s'} (backlog {18}, peak {19})\n",
 				benchmark.ReadWriteFileTime,
 				benchmark.QueryCompletionPortTime,
 				benchmark.TransferTime,
@@ -343,7 +1136,17 @@ namespace ExxonMobil.IOBench.Cli
 				benchmark.CompletedSynchronously,
 				(double)bytesPerSecond / (1024 * 1024),
 				(double)bytesPerSecond * 8 / 1000000,
-                instantText);
+                instantText,
+				benchmark.TransferCpuUsage.UserTime,
+				benchmark.TransferCpuUsage.KernelTime,
+				benchmark.CpuMicrosecondsPerIO,
+				benchmark.CyclesPerIO,
+				benchmark.TransferCpuUsage.ContextSwitches,
+				benchmark.SyscallsPerIO,
+				benchmark.VerifyTime,
+				(double)benchmark.AverageBytesVerifiedPerSec / (1024 * 1024),
+				benchmark.VerifyBacklog,
+				benchmark.VerifyBacklogPeak);
 			Console.WriteLine(text);
 		}
 
@@ -497,14 +1300,48 @@ namespace ExxonMobil.IOBench.Cli
 			return text;
 		}
 
+		// Parses [group:]list where list is comma separated processor numbers or ranges, 
+		// e.g. 0-3,8 or 1:0-15.
+		private static ulong ParseCpuList(string val, out int group)
+		{
+			group = 0;
+			var list = val;
+			var colon = val.IndexOf(':');
+			if (colon >= 0)
+			{
+				if (!int.TryParse(val.Substring(0, colon), out group))
+					throw new IOBenchCliException("Invalid processor group: " + val);
+				list = val.Substring(colon + 1);
+			}
+
+			ulong mask = 0;
+			foreach (var item in list.Split(','))
+			{
+				var bounds = item.Split('-');
+				uint first, last;
+				if (bounds.Length > 2 || !uint.TryParse(bounds[0], out first))
+					throw new IOBenchCliException("Invalid processor list: " + val);
+				last = first;
+				if (bounds.Length == 2 && !uint.TryParse(bounds[1], out last))
+					throw new IOBenchCliException("Invalid processor list: " + val);
+				if (last < first || last > 63)
+					throw new IOBenchCliException("Processors must be between 0 and 63 within a group: " + val);
+				for (var cpu = first; cpu <= last; cpu++)
+					mask |= 1UL << (int)cpu;
+			}
+			return mask;
+		}
+
 		static BenchmarkConfiguration ProcessBenchmarkArgs(ConsoleArguments args)
 		{
 			var config = new BenchmarkConfiguration();
 
-			if (args.Anonymous.Count != 1)
+			// An emulated device needs no file; its name stands in for the path.
+			bool emulated = args.Named.ContainsKey("dev");
+			if (args.Anonymous.Count > 1 || (args.Anonymous.Count == 0 && !emulated))
 				throw new IOBenchCliException("Benchmark only takes one argumnet: file path.");
 
-			config.FilePath = args.Anonymous.First();
+			config.FilePath = args.Anonymous.FirstOrDefault();
 
 			bool blockCountSet = false;
 			long fileSizeBytes = 0;
@@ -520,15 +1357,66 @@ namespace ExxonMobil.IOBench.Cli
 					case "as":
 						config.Asynchronous = true;
 						break;
+					case "sa":
+						config.Asynchronous = true;
+						config.NoBuffering = true;
+						config.StrictAsync = true;
+						break;
 					case "mo":
 						if (!uint.TryParse(val, out intVal))
 							throw new IOBenchCliException("Invalid max outstanding: " + val);
 						config.AsyncMaxBlocksOutstanding = (int)intVal;
 						break;
-					case "bc":
+					case "cm":
+						switch (val)
+						{
+							case "block":
+								config.CompletionMode = CompletionMode.Block;
+								break;
+							case "poll":
+								config.CompletionMode = CompletionMode.Poll;
+								break;
+							case "hybrid":
+								config.CompletionMode = CompletionMode.Hybrid;
+								break;
+							case "ovp":
+								config.CompletionMode = CompletionMode.PollOverlapped;
+								break;
+							default:
+								throw new IOBenchCliException("Invalid completion mode: " + val);
+						}
+						break;
+					case "spin":
 						if (!uint.TryParse(val, out intVal))
+							throw new IOBenchCliException("Invalid spin time: " + val);
+						config.HybridSpinMicroseconds = (int)intVal;
+						break;
+					case "numa":
+						if (val == "auto")
+							config.AutoNumaNode = true;
+						else if (uint.TryParse(val, out intVal))
+							config.NumaNode = (int)intVal;
+						else
+							throw new IOBenchCliException("Invalid NUMA node: " + val);
+						break;
+					case "cpus":
+						int cpuGroup;
+						config.CpuMask = ParseCpuList(val, out cpuGroup);
+						config.CpuGroup = cpuGroup;
+						break;
+					case "sb":
+						if (val == "auto")
+							config.AdaptiveSubmitBatch = true;
+						else if (uint.TryParse(val, out intVal))
+							config.SubmitBatch = (int)intVal;
+						else
+							throw new IOBenchCliException("Invalid submit batch: " + val);
+						break;
+					case "bc":
+						ulong blockCount;
+						if (!ulong.TryParse(val, out blockCount) || blockCount > long.MaxValue)
 							throw new IOBenchCliException("Invalid block count: " + val);
-						config.Blocks = (int)intVal;
+						config.Blocks = (long)blockCount;
 						blockCountSet = true;
 						break;
 					case "bs":
@@ -574,6 +1462,263 @@ namespace ExxonMobil.IOBench.Cli
 					case "rf":
 						resultFilePath = val;
 						break;
+					case JsonOption:
+						if (!String.IsNullOrWhiteSpace(val))
+							jsonFilePath = val;
+						break;
+					case "prom":
+						if (!ushort.TryParse(val, out prometheusPort) || prometheusPort == 0)
+							throw new IOBenchCliException("Invalid metrics port: " + val);
+						break;
+					case "promall":
+						prometheusAllInterfaces = true;
+						break;
+					case "coord":
+						if (!uint.TryParse(val, out intVal) || intVal < 1 || intVal > 1024)
+							throw new IOBenchCliException("Invalid worker count (1-1024): " + val);
+						coordinatedWorkers = (int)intVal;
+						break;
+					case "port":
+						if (!ushort.TryParse(val, out coordinatorPort) || coordinatorPort == 0)
+							throw new IOBenchCliException("Invalid coordinator port: " + val);
+						break;
+					case "spawn":
+						spawnWorkers = true;
+						break;
+					case "worker":
+						if (String.IsNullOrWhiteSpace(val))
+							throw new IOBenchCliException("Invalid coordinator address.") { HelpText = "Use -worker=host:port." };
+						workerEndpoint = val;
+						break;
+					case "interval":
+						if (!uint.TryParse(val, out intVal) || intVal == 0 || intVal > 3600)
+							throw new IOBenchCliException("Invalid metrics interval (1-3600 seconds): " + val);
+						metricsInterval = (int)intVal * 1000;
+						break;
+					case "depth":
+						if (!uint.TryParse(val, out intVal))
+							throw new IOBenchCliException("Invalid tree depth: " + val);
+						config.MetadataDepth = (int)intVal;
+						break;
+					case "fanout":
+						if (!uint.TryParse(val, out intVal))
+							throw new IOBenchCliException("Invalid tree fanout: " + val);
+						config.MetadataFanout = (int)intVal;
+						break;
+					case "fpd":
+						if (!uint.TryParse(val, out intVal))
+							throw new IOBenchCliException("Invalid files per directory: " + val);
+						config.MetadataFilesPerDirectory = (int)intVal;
+						break;
+					case "threads":
+						if (!uint.TryParse(val, out intVal))
+							throw new IOBenchCliException("Invalid thread count: " + val);
+						config.MetadataThreads = (int)intVal;
+						break;
+					case "payload":
+						if (!uint.TryParse(val, out intVal))
+							throw new IOBenchCliException("Invalid payload size: " + val);
+						config.MetadataPayloadBytes = (int)intVal;
+						break;
+					case "cache":
+						if (val == "cold")
+							config.CacheState = CacheState.Cold;
+						else if (val == "hot")
+							config.CacheState = CacheState.Hot;
+						else if (uint.TryParse(val, out intVal))
+						{
+							config.CacheState = CacheState.Partial;
+							config.CachePrimePercent = (int)intVal;
+						}
+						else
+							throw new IOBenchCliException("Invalid cache state (cold,hot,#): " + val);
+						break;
+					case "vt":
+						if (!uint.TryParse(val, out intVal))
+							throw new IOBenchCliException("Invalid verifier thread count: " + val);
+						config.VerifyThreads = (int)intVal;
+						break;
+					case "tmix":
+						if (!uint.TryParse(val, out intVal))
+							throw new IOBenchCliException("Invalid trim mix: " + val);
+						config.TrimPercent = (int)intVal;
+						break;
+					case "trim":
+						switch (val)
+						{
+							case "punch":
+								config.TrimType = TrimType.Punch;
+								break;
+							case "discard":
+								config.TrimType = TrimType.Discard;
+								break;
+							default:
+								throw new IOBenchCliException("Invalid trim type (punch,discard): " + val);
+						}
+						break;
+					case "probe":
+						if (!uint.TryParse(val, out intVal))
+							throw new IOBenchCliException("Invalid write probe block count: " + val);
+						config.TrimProbeBlocks = (int)intVal;
+						break;
+					case "trace":
+						config.TraceFilePath = val;
+						break;
+					case "ts":
+						double scale;
+						if (!double.TryParse(val, NumberStyles.Float, CultureInfo.InvariantCulture, out scale))
+							throw new IOBenchCliException("Invalid time scale: " + val);
+						config.ReplayTimeScale = scale;
+						break;
+					case "dev":
+						switch (val)
+						{
+							case "null":
+								config.Device = DeviceType.Null;
+								break;
+							case "ram":
+								config.Device = DeviceType.Ram;
+								break;
+							default:
+								throw new IOBenchCliException("Invalid emulated device (null,ram): " + val);
+						}
+						if (config.FilePath == null)
+							config.FilePath = val;
+						break;
+					case "devq":
+						if (!uint.TryParse(val, out intVal))
+							throw new IOBenchCliException("Invalid device parallelism: " + val);
+						config.DeviceParallelism = (int)intVal;
+						break;
+					case "lat":
+						ParseLatencyModel(val, config);
+						break;
+					case "shared":
+						if (!uint.TryParse(val, out intVal) || intVal == 0)
+							throw new IOBenchCliException("Invalid shared file thread count: " + val);
+						config.Sharers = (int)intVal;
+						break;
+					case "layout":
+						switch (val)
+						{
+							case "segment":
+								config.SharedLayout = SharedLayout.Segment;
+								break;
+							case "interleave":
+								config.SharedLayout = SharedLayout.Interleave;
+								break;
+							default:
+								throw new IOBenchCliException("Invalid shared file layout (segment,interleave): " + val);
+						}
+						break;
+					case "lock":
+						config.LockRanges = true;
+						break;
+					case "append":
+						config.AppendWrites = true;
+						break;
+					case "precond":
+						ParsePrecondition(val, config);
+						break;
+					case "reprecond":
+						config.RepeatPrecondition = true;
+						break;
+					case "force":
+						config.ForceDeviceWrites = true;
+						break;
+					case "repeat":
+						if (!uint.TryParse(val, out intVal) || intVal < 2 || intVal > 1000)
+							throw new IOBenchCliException("Invalid repetition count (2-1000): " + val);
+						repeatCount = (int)intVal;
+						break;
+					case "baseline":
+						if (String.IsNullOrWhiteSpace(val))
+							throw new IOBenchCliException("Invalid baseline file.");
+						baselinePath = arg.Value;
+						break;
+					case "basetag":
+						if (String.IsNullOrWhiteSpace(val))
+							throw new IOBenchCliException("Invalid baseline tag.");
+						baselineTag = arg.Value;
+						break;
+					case "prio":
+						switch (val)
+						{
+							case "verylow":
+								config.IoPriority = IoPriority.VeryLow;
+								break;
+							case "low":
+								config.IoPriority = IoPriority.Low;
+								break;
+							case "normal":
+								config.IoPriority = IoPriority.Normal;
+								break;
+							default:
+								throw new IOBenchCliException("Invalid I/O priority (verylow,low,normal): " + val);
+						}
+						break;
+					case "rate":
+						if (!uint.TryParse(val, out intVal) || intVal == 0)
+							throw new IOBenchCliException("Invalid rate: " + val);
+						config.RateBytesPerSec = (long)intVal * 1024 * 1024;
+						break;
+					case "streams":
+						if (!uint.TryParse(val, out intVal) || intVal == 0)
+							throw new IOBenchCliException("Invalid stream count: " + val);
+						config.Streams = (int)intVal;
+						break;
+					case "sorder":
+						switch (val)
+						{
+							case "rr":
+								config.StreamOrder = StreamOrder.RoundRobin;
+								break;
+							case "random":
+								config.StreamOrder = StreamOrder.Random;
+								break;
+							default:
+								throw new IOBenchCliException("Invalid stream order (rr,random): " + val);
+						}
+						break;
+					case "stride":
+						if (!uint.TryParse(val, out intVal) || intVal == 0 || intVal > int.MaxValue)
+							throw new IOBenchCliException("Invalid stream stride: " + val);
+						config.StreamStride = (int)intVal;
+						break;
+					case "reverse":
+						config.StreamReverse = true;
+						break;
+					case "sg":
+						config.ScatterGather = true;
+						switch (val)
+						{
+							case "":
+							case "contig":
+								config.SegmentLayout = SegmentLayout.Contiguous;
+								break;
+							case "scatter":
+								config.SegmentLayout = SegmentLayout.Scattered;
+								break;
+							default:
+								throw new IOBenchCliException("Invalid segment layout (contig,scatter): " + val);
+						}
+						break;
+					case "prod":
+						if (!uint.TryParse(val, out intVal))
+							throw new IOBenchCliException("Invalid log producer count: " + val);
+						config.WalProducers = (int)intVal;
+						break;
+					case "rec":
+						ParseRecordSizes(val, config);
+						break;
+					case "commit":
+						if (!uint.TryParse(val, out intVal) || intVal > int.MaxValue)
+							throw new IOBenchCliException("Invalid commit interval: " + val);
+						config.WalCommitMicroseconds = (int)intVal;
+						break;
+					case "afap":
+						config.ReplayTimed = false;
+						break;
 					case "tag":
 						if (String.IsNullOrWhiteSpace(val))
 							throw new IOBenchCliException("Invalid tag.");
@@ -616,8 +1761,27 @@ namespace ExxonMobil.IOBench.Cli
 								config.Operation = BenchmarkOperation.Write;
 								config.FilePerBlock = true;
 								break;
+							case "st":
+								config.AccessPattern = AccessPattern.Sequential;
+								config.Operation = BenchmarkOperation.Trim;
+								break;
+							case "rt":
+								config.AccessPattern = AccessPattern.Random;
+								config.Operation = BenchmarkOperation.Trim;
+								break;
+							case "rp":
+								config.AccessPattern = AccessPattern.Replay;
+								config.Asynchronous = true;
+								break;
+							case "md":
+								config.AccessPattern = AccessPattern.Metadata;
+								break;
+							case "wal":
+								config.AccessPattern = AccessPattern.Log;
+								config.Operation = BenchmarkOperation.Write;
+								break;
 							default:
-								throw new IOBenchCliException("Invalid operation (rr,rw,sr,sw,fr,fw): " + val);
+								throw new IOBenchCliException("Invalid operation (rr,rw,sr,sw,fr,fw,st,rt,rp,md,wal): " + val);
 						}
 						break;
 					default:
@@ -625,6 +1789,28 @@ namespace ExxonMobil.IOBench.Cli
 				}
 			}
 
+			if (coordinatedWorkers == 0 && (spawnWorkers || coordinatorPort != 0))
+				throw new IOBenchCliException("-spawn and -port only apply to a coordinator (-coord).");
+			if (coordinatedWorkers > 0 && workerEndpoint != null)
+				throw new IOBenchCliException("A process can not be both a coordinator and a worker.");
+			if (coordinatedWorkers > 0 && !spawnWorkers && coordinatorPort == 0)
+				throw new IOBenchCliException("Workers started separately need a fixed -port to connect to.");
+			if (coordinatedWorkers > 0 && (resultFilePath != null || args.Named.ContainsKey(JsonOption) || prometheusPort != 0 || enableNetworkAnalysis))
+				throw new IOBenchCliException("A coordinator reports on the console and can not be combined with -rf, -json, -prom or -na.");
+			if (prometheusAllInterfaces && prometheusPort == 0)
+				throw new IOBenchCliException("-promall only applies to a metrics port (-prom).");
+
+			if (enableNetworkAnalysis && config.IsEmulated)
+				throw new IOBenchCliException("Network analysis needs a file path, not an emulated device.");
+			if (repeatCount > 1 && (coordinatedWorkers > 0 || workerEndpoint != null || args.Named.ContainsKey(JsonOption) || prometheusPort != 0 || enableNetworkAnalysis))
+				throw new IOBenchCliException("Repetitions report on the console and can not be combined with -coord, -worker, -json, -prom or -na.");
+			if (baselinePath != null && repeatCount < 2)
+				throw new IOBenchCliException("A baseline is compared with repetitions and needs -repeat.");
+			if (baselineTag != null && baselinePath == null)
+				throw new IOBenchCliException("-basetag only applies to -baseline.");
+			if (coordinatedWorkers > 0 && config.IsDevice)
+				throw new IOBenchCliException("Coordinated workers each run against a file of their own and can not share a raw device.");
+
 			if (fileSizeBytes > 0)
 			{
 				if (blockCountSet)
@@ -633,12 +1819,114 @@ namespace ExxonMobil.IOBench.Cli
 				if (fileSizeBytes % config.BlockSizeBytes != 0)
 					throw new IOBenchCliException("File size must be a multiple of the block size.");
 
-				config.Blocks = (int)(fileSizeBytes / config.BlockSizeBytes);
+				config.Blocks = fileSizeBytes / config.BlockSizeBytes;
 			}
 
 			return config;
 		}
 
+		// fixed,MEAN  normal,MEAN,DEV  tail,MEAN,DEV,STALL,PERMILLION with times in microseconds.
+		static void ParseLatencyModel(string val, BenchmarkConfiguration config)
+		{
+			var parts = val.Split(',');
+			var values = new uint[parts.Length - 1];
+			for (int i = 1; i < parts.Length; i++)
+			{
+				if (!uint.TryParse(parts[i], out values[i - 1]) || values[i - 1] > int.MaxValue)
+					throw new IOBenchCliException("Invalid latency model value: " + parts[i]);
+			}
+
+			int expected;
+			switch (parts[0])
+			{
+				case "fixed":
+					config.LatencyModel = LatencyModelType.Fixed;
+					expected = 1;
+					break;
+				case "normal":
+					config.LatencyModel = LatencyModelType.Normal;
+					expected = 2;
+					break;
+				case "tail":
+					config.LatencyModel = LatencyModelType.LongTail;
+					expected = 4;
+					break;
+				default:
+					throw new IOBenchCliException("Invalid latency model (fixed,normal,tail): " + parts[0]);
+			}
+			if (values.Length != expected)
+				throw new IOBenchCliException("Latency model " + parts[0] + " takes " + expected + " value(s): " + val);
+
+			config.LatencyMicroseconds = (int)values[0];
+			if (expected > 1)
+				config.LatencyDeviationMicroseconds = (int)values[1];
+			if (expected > 2)
+			{
+				config.StallMicroseconds = (int)values[2];
+				config.StallsPerMillion = (int)values[3];
+			}
+		}
+
+		static void ParsePrecondition(string val, BenchmarkConfiguration config)
+		{
+			var parts = val.Split(',');
+			uint passes, rounds = 0;
+			if (parts.Length > 2 || !uint.TryParse(parts[0], out passes) || (parts.Length == 2 && !uint.TryParse(parts[1], out rounds)))
+				throw new IOBenchCliException("Invalid preconditioning (passes[,rounds]): " + val);
+			config.PreconditionPasses = (int)passes;
+			config.PreconditionRounds = (int)rounds;
+		}
+
+		static void ParseRecordSizes(string val, BenchmarkConfiguration config)
+		{
+			var parts = val.Split(',');
+			var values = new uint[parts.Length - 1];
+			for (int i = 1; i < parts.Length; i++)
+			{
+				if (!uint.TryParse(parts[i], out values[i - 1]) || values[i - 1] > int.MaxValue)
+					throw new IOBenchCliException("Invalid record size: " + parts[i]);
+			}
+
+			int expected;
+			switch (parts[0])
+			{
+				case "fixed":
+					config.WalRecordModel = RecordSizeModel.Fixed;
+					expected = 1;
+					break;
+				case "uniform":
+					config.WalRecordModel = RecordSizeModel.Uniform;
+					expected = 2;
+					break;
+				case "exp":
+					config.WalRecordModel = RecordSizeModel.Exponential;
+					expected = 2;
+					break;
+				default:
+					throw new IOBenchCliException("Invalid record size distribution (fixed,uniform,exp): " + parts[0]);
+			}
+			if (values.Length != expected)
+				throw new IOBenchCliException("Record size distribution " + parts[0] + " takes " + expected + " value(s): " + val);
+
+			if (config.WalRecordModel == RecordSizeModel.Fixed)
+			{
+				config.WalRecordBytes = (int)values[0];
+				config.WalMinRecordBytes = (int)values[0];
+				config.WalMaxRecordBytes = (int)values[0];
+			}
+			else if (config.WalRecordModel == RecordSizeModel.Uniform)
+			{
+				config.WalMinRecordBytes = (int)values[0];
+				config.WalMaxRecordBytes = (int)values[1];
+			}
+			else
+			{
+				config.WalRecordBytes = (int)values[0];
+				config.WalMinRecordBytes = 1;
+				config.WalMaxRecordBytes = (int)values[1];
+			}
+		}
+
 		static void PrintUsage()
 		{
 			Console.WriteLine(Properties.Resources.HelpText);
@@ -85,7 +85,7 @@ namespace ExxonMobil.IOBench.Core
 		protected SafeFileHandle CreateFile(string filePath)
 		{
 			var attributes = Win32FileAttributes.Normal;
-			if (config.Asynchronous) attributes |= Win32FileAttributes.Overlapped;
+			if (config.IsOverlapped) attributes |= Win32FileAttributes.Overlapped;
 			if (config.NoBuffering) attributes |= Win32FileAttributes.NoBuffering;
 			if (config.WriteThrough) attributes |= Win32FileAttributes.WriteThrough;
 			if (!config.NoOperationHints)
@@ -95,13 +95,44 @@ namespace ExxonMobil.IOBench.Core
 			}
 
 			var access = config.IsRead ? Win32FileAccess.GenericRead : Win32FileAccess.GenericWrite;
+			var share = config.IsRead ? Win32FileShare.Read : Win32FileShare.None;
 			var disposition = config.IsRead ? Win32FileCreationDisposition.OpenAlways : Win32FileCreationDisposition.CreateAlways;
+			if (config.IsTrim)
+				disposition = Win32FileCreationDisposition.OpenExisting;
+			if (config.IsReplay)
+			{
+				// Traces mix reads and writes and are replayed over the existing file contents.
+				access = Win32FileAccess.GenericRead | Win32FileAccess.GenericWrite;
+				disposition = Win32FileCreationDisposition.OpenAlways;
+			}
+			if (config.IsPreconditioned && config.IsWrite)
+			{
+				// Writes overwrite the conditioned file in place rather than start a new one.
+				disposition = Win32FileCreationDisposition.OpenAlways;
+			}
+			if (config.IsSharedFile)
+			{
+				// Every sharer opens the one file, so none of them may truncate it. An append only 
+				// handle writes at the end of the file whatever offset it is given.
+				share = Win32FileShare.Read | Win32FileShare.Write;
+				if (config.IsWrite)
+					disposition = Win32FileCreationDisposition.OpenAlways;
+				if (config.AppendWrites)
+					access = Win32FileAccess.AppendData | Win32FileAccess.Synchronize;
+			}
+			if (config.IsDevice)
+			{
+				// A disk is always there to open and can not be created or truncated. The volume 
+				// stack keeps its own handles open, so exclusive access would be refused.
+				share = Win32FileShare.Read | Win32FileShare.Write;
+				disposition = Win32FileCreationDisposition.OpenExisting;
+			}
 
 			createFileTime.Start();
 			var fileHandle = Win32Methods.CreateFile(
 				filePath,
 				access,
-				config.IsRead ? Win32FileShare.Read : Win32FileShare.None,
+				share,
 				IntPtr.Zero,
 				disposition,
 				attributes,
@@ -114,14 +145,18 @@ namespace ExxonMobil.IOBench.Core
 				throw new Win32Exception(err);
 
 			if (config.DisableLocalBuffering)
-				if (!NativeCore.DisableLocalBuffering(fileHandle, config.Asynchronous))
+				if (!NativeCore.DisableLocalBuffering(fileHandle, config.IsOverlapped))
 					throw new BenchmarkException("Failed to send file system control code to disable local buffering.") 
 					{ HelpText = "Disable local buffering is only valid for remote files." };
 
 			if (config.EnableRemotePrefetch)
-				if (!NativeCore.Experimental_EnableRemotePrefetch(fileHandle, config.Asynchronous))
+				if (!NativeCore.Experimental_EnableRemotePrefetch(fileHandle, config.IsOverlapped))
 					throw new BenchmarkException("Failed to enable remote prefetch.");
 
+			if (config.IoPriority.HasValue)
+				if (!NativeCore.SetIoPriorityHint(fileHandle, config.IoPriority.Value))
+					throw new BenchmarkException("Failed to set the I/O priority hint.", new Win32Exception());
+
 			return fileHandle;
 		}
 
@@ -163,45 +198,78 @@ namespace ExxonMobil.IOBench.Core
 
         public Task Start(CancellationToken token)
         {
-			token.Register(() => status.Canceled = true);
+			token.Register(Cancel);
 			return Task.Factory.StartNew(() => StartTask(token), token, TaskCreationOptions.LongRunning, TaskScheduler.Default);
         }
 
+		// Ends the run at the next request. Unlike canceling, the run then completes normally 
+		// with whatever it transferred up to that point.
+		public void Stop()
+		{
+			Cancel();
+		}
+
+		// Stops the native loops at their next request.
+		protected virtual void Cancel()
+		{
+			status.Canceled = true;
+		}
+
+		// Opens, sizes and conditions the target ahead of the transfer, so that whatever starts 
+		// the run afterwards times only the transfer itself. Starting runs it first when it has 
+		// not been called.
+		public void Prepare()
+		{
+			if (prepared)
+				return;
+			prepared = true;
+			PrepareRun();
+		}
+
 		private void StartTask(CancellationToken token)
 		{
+			Prepare();
 			this.Run();
 			token.ThrowIfCancellationRequested();
 		}
 
 		public static Benchmark Create(BenchmarkConfiguration config)
         {
+			if (config.IsMetadata)
+				return new MetadataBenchmark(config);
             var benchmark = new FileBenchmark(config);
             return benchmark;
         }
 
-        public int CompletedSynchronously
+        public long CompletedSynchronously
         {
-            get { return status.CompletedSync; }
+            get { return Counters.CompletedSync; }
         }
 
-        public int CompletedAsynchronously
+        public long CompletedAsynchronously
         {
-            get { return status.CompletedAsync; }
+            get { return Counters.CompletedAsync; }
         }
 
+        // Trim operations move no data. Their progress is the bytes trimmed.
         public long BytesTransferred
         {
-            get { return (long)status.BlocksTransferred * (long)config.BlockSizeBytes; }
+            get { return config.IsTrim ? TrimmedBytes : Counters.BytesTransferred; }
         }
 
+		public long TrimmedBytes
+		{
+			get { return Counters.TrimmedBytes; }
+		}
+
 		public long BytesTotal
         {
             get { return bytesTotal; }
         }
 
-        public int BlocksTransferred
+        public long BlocksTransferred
         {
-            get { return status.BlocksTransferred; }
+            get { return Counters.BlocksTransferred; }
         }
 
 		public long AverageBytesTransferredPerSec
@@ -244,13 +312,13 @@ namespace ExxonMobil.IOBench.Core
 
 		public double PercentComplete
 		{
-			get { return (double)status.BlocksTransferred / (double)config.Blocks; }
+			get { return (double)BlocksTransferred / (double)config.Blocks; }
 		}
 
         public TimeSpan ReadWriteFileTime
         {
             get {
-                return PerfCountToTimeSpan(ref status.ReadWriteFilePerfCounts);
+                return PerfCountToTimeSpan(Counters.ReadWriteFilePerfCounts);
             }
         }
 
@@ -258,10 +326,138 @@ namespace ExxonMobil.IOBench.Core
         {
             get
             {
-                return PerfCountToTimeSpan(ref status.GetQueuedCompletionStatusExPerfCounts);
+                return PerfCountToTimeSpan(Counters.GetQueuedCompletionStatusExPerfCounts);
             }
         }
 
+		public TimeSpan ScheduleLagTime
+		{
+			get
+			{
+				return PerfCountToTimeSpan(Counters.ScheduleLagPerfCounts);
+			}
+		}
+
+		public LatencyHistogram Latency
+		{
+			get { return LatencyHistogram.FromNative(ref status.Latency); }
+		}
+
+		// Asynchronous reads verified off the completion loop. The backlog is the number of 
+		// buffers waiting on a verifier thread.
+		public long VerifiedBytes
+		{
+			get { return Counters.VerifiedBytes; }
+		}
+
+		public long VerifyBacklog
+		{
+			get { return Interlocked.Read(ref status.VerifyBacklog); }
+		}
+
+		public long VerifyBacklogPeak
+		{
+			get { return Interlocked.Read(ref status.VerifyBacklogPeak); }
+		}
+
+		// Time spent verifying summed over the verifier threads.
+		public TimeSpan VerifyTime
+		{
+			get { return PerfCountToTimeSpan(Counters.VerifyPerfCounts); }
+		}
+
+		public long AverageBytesVerifiedPerSec
+		{
+			get
+			{
+				long elapsedms = transferTime.ElapsedMilliseconds;
+				return elapsedms == 0 ? 0 : VerifiedBytes * 1000 / elapsedms;
+			}
+		}
+
+		public LatencyHistogram TrimLatency
+		{
+			get { return LatencyHistogram.FromNative(ref status.TrimLatency); }
+		}
+
+		// Write latency over the start of the file before and after the trim pass of a trim 
+		// operation, or null.
+		public LatencyHistogram WriteLatencyBeforeTrim { get; protected set; }
+		public LatencyHistogram WriteLatencyAfterTrim { get; protected set; }
+
+		// System file cache size right before and after the transfer, and the bytes read to 
+		// prime the cache for a hot or partial read. Windows has no per-file residency query.
+		public long SystemCacheBytesBefore { get; protected set; }
+		public long SystemCacheBytesAfter { get; protected set; }
+		public long CachePrimedBytes { get; protected set; }
+
+		// Where the issuing thread and its buffers were placed, or null when unplaced.
+		public string Placement { get; protected set; }
+
+		// Latency recorded in the source trace of a replay, or null.
+		public LatencyHistogram RecordedLatency { get; protected set; }
+
+		// ReadFile/WriteFile calls plus completion port waits.
+		public long SubmitCalls
+		{
+			get { return Counters.SubmitCalls; }
+		}
+
+		public long CompletionCalls
+		{
+			get { return Counters.CompletionCalls; }
+		}
+
+		// Requests still outstanding after the last completion batch. Synchronous transfers 
+		// report none.
+		public long InFlight
+		{
+			get { return Counters.InFlight; }
+		}
+
+		public double SyscallsPerIO
+		{
+			get
+			{
+				long blocks = BlocksTransferred;
+				return blocks == 0 ? 0 : (double)(SubmitCalls + CompletionCalls) / blocks;
+			}
+		}
+
+		// Cpu usage of the thread issuing I/O during the transfer phase. Updated as each 
+		// transfer completes.
+		public CpuUsage TransferCpuUsage
+		{
+			get { return transferCpuUsage; }
+		}
+
+		public double CpuMicrosecondsPerIO
+		{
+			get
+			{
+				long blocks = BlocksTransferred;
+				return blocks == 0 ? 0 : transferCpuUsage.TotalTime.TotalMilliseconds * 1000 / blocks;
+			}
+		}
+
+		public double CpuSecondsPerGB
+		{
+			get
+			{
+				long bytes = BytesTransferred;
+				return bytes == 0 ? 0 : transferCpuUsage.TotalTime.TotalSeconds * (1L << 30) / bytes;
+			}
+		}
+
+		public double CyclesPerIO
+		{
+			get
+			{
+				long blocks = BlocksTransferred;
+				return blocks == 0 ? 0 : (double)transferCpuUsage.Cycles / blocks;
+			}
+		}
+
 		public TimeSpan TransferTime
 		{
 			get
@@ -294,15 +490,108 @@ namespace ExxonMobil.IOBench.Core
 			}
 		}
 
+		// The first start and the last stop of the transfer clock on the Stopwatch timestamp 
+		// scale, so a caller can place the transfer against its own clock.
+		public long TransferStartTimestamp
+		{
+			get { return transferStartTimestamp; }
+		}
+
+		public long TransferEndTimestamp
+		{
+			get { return transferEndTimestamp; }
+		}
+
+		protected virtual void PrepareRun()
+		{
+		}
+
 		protected abstract void Run();
 
-        private TimeSpan PerfCountToTimeSpan(ref long countSource)
+		protected void StartTransferClock()
+		{
+			if (transferStartTimestamp == 0)
+				transferStartTimestamp = Stopwatch.GetTimestamp();
+			transferTime.Start();
+		}
+
+		protected void StopTransferClock()
+		{
+			transferTime.Stop();
+			transferEndTimestamp = Stopwatch.GetTimestamp();
+		}
+
+        private TimeSpan PerfCountToTimeSpan(long count)
         {
-            long count = Interlocked.Read(ref countSource);
             double ticks = count * tickFrequency;
             return new TimeSpan((long)ticks);
         }
 
+		// Every worker's counters summed. Each block is copied under its sequence lock, so the 
+		// fields of one worker always come from the same update, however often this is read.
+		internal unsafe NativeStatCounters Counters
+		{
+			get
+			{
+				var total = new NativeStatCounters();
+				fixed (byte* workers = status.Workers)
+				{
+					var blocks = (NativeStatBlock*)workers;
+					for (int i = 0; i < NativeCore.STATUS_MAX_WORKERS; i++)
+					{
+						var counters = ReadStatBlock(blocks + i);
+						total.Add(ref counters);
+					}
+				}
+				return total;
+			}
+		}
+
+		// One worker's counters, such as a single sharer of a shared file.
+		internal unsafe NativeStatCounters GetWorkerCounters(int worker)
+		{
+			fixed (byte* workers = status.Workers)
+				return ReadStatBlock((NativeStatBlock*)workers + worker);
+		}
+
+		private static unsafe NativeStatCounters ReadStatBlock(NativeStatBlock* block)
+		{
+			var spin = new SpinWait();
+			for (;;)
+			{
+				int sequence = Volatile.Read(ref block->Sequence);
+				if ((sequence & 1) == 0)
+				{
+					var counters = block->Counters;
+					Thread.MemoryBarrier();
+					if (Volatile.Read(ref block->Sequence) == sequence)
+						return counters;
+				}
+				spin.SpinOnce();
+			}
+		}
+
+		// Adds progress for managed worker threads. Blocks are shared once there are more 
+		// workers than blocks, so writers claim a block by moving its sequence from even to odd.
+		protected unsafe void AddProgress(int worker, long blocks, long bytes)
+		{
+			fixed (byte* workers = status.Workers)
+			{
+				var block = (NativeStatBlock*)workers + worker % NativeCore.STATUS_MAX_WORKERS;
+				var spin = new SpinWait();
+				for (;;)
+				{
+					int sequence = Volatile.Read(ref block->Sequence);
+					if ((sequence & 1) == 0 && Interlocked.CompareExchange(ref block->Sequence, sequence + 1, sequence) == sequence)
+						break;
+					spin.SpinOnce();
+				}
+				block->Counters.BlocksTransferred += blocks;
+				block->Counters.BytesTransferred += bytes;
+				Interlocked.Increment(ref block->Sequence);
+			}
+		}
+
 		protected BenchmarkConfiguration config;
         internal NativeCoreStatus status;
 
@@ -314,8 +603,12 @@ namespace ExxonMobil.IOBench.Core
 		protected Stopwatch preallocTime = new Stopwatch();
 		protected Stopwatch createFileTime = new Stopwatch();
         protected Stopwatch wallTime = new Stopwatch();
+		protected CpuUsage transferCpuUsage = new CpuUsage();
+		private long transferStartTimestamp;
+		private long transferEndTimestamp;
+		private bool prepared;
 
-		private long bytesTotal;
+		protected long bytesTotal;
         private static readonly double tickFrequency;
 		private static bool requestedManageVolumePrivilege = false;
     }
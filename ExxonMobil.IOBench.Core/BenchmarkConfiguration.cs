@@ -17,7 +17,6 @@ using System.Linq;
 using System.Text;
 using System.IO;
 using ExxonMobil.Shared.Logging;
-using System.Collections;
 using ExxonMobil.Shared.Win32;
 
 namespace ExxonMobil.IOBench.Core
@@ -28,6 +27,22 @@ namespace ExxonMobil.IOBench.Core
 		{
 			Asynchronous = false;
 			AsyncMaxBlocksOutstanding = 8;
+			SubmitBatch = 1;
+			CompletionMode = CompletionMode.Block;
+			HybridSpinMicroseconds = 50;
+			TrimType = TrimType.Punch;
+			TrimProbeBlocks = 1024;
+			VerifyThreads = 2;
+			MetadataDepth = 2;
+			MetadataFanout = 8;
+			MetadataFilesPerDirectory = 64;
+			MetadataThreads = 1;
+			WalProducers = 4;
+			StreamStride = 1;
+			WalRecordModel = RecordSizeModel.Uniform;
+			WalRecordBytes = 512;
+			WalMinRecordBytes = 128;
+			WalMaxRecordBytes = 4096;
 			Blocks = 1024; //1GB
 			BlockSizeBytes = 1024 * 1024; //1MB
 			NoBuffering = false;
@@ -37,6 +52,8 @@ namespace ExxonMobil.IOBench.Core
 			WriteThrough = false;
 			Preallocation = PreallocationType.None;
 			WriteDataType = WriteDataType.Counter;
+			ReplayTimed = true;
+			ReplayTimeScale = 1.0;
 			Name = "Untitled";
 		}
 
@@ -46,12 +63,25 @@ namespace ExxonMobil.IOBench.Core
         public string FilePath { get; set; }
 		public bool FilePerBlock { get; set; }
 
-        public int Blocks { get; set; }
+        public long Blocks { get; set; }
         public int BlockSizeBytes { get; set; }
         public int AsyncMaxBlocksOutstanding { get; set; }
+		public int SubmitBatch { get; set; }
+		public bool AdaptiveSubmitBatch { get; set; }
+		public CompletionMode CompletionMode { get; set; }
+		public int HybridSpinMicroseconds { get; set; }
+
+		// Placement of the issuing thread and its buffers. CpuMask selects processors within 
+		// CpuGroup and takes precedence over the processors of the NUMA node.
+		public int? NumaNode { get; set; }
+		public bool AutoNumaNode { get; set; }
+		public int CpuGroup { get; set; }
+		public ulong CpuMask { get; set; }
         public bool ReadVerify { get; set; }
+		public int VerifyThreads { get; set; }
 
         public bool Asynchronous { get; set; }
+		public bool StrictAsync { get; set; }
 		public bool DisableLocalBuffering { get; set; }
         public bool NoBuffering { get; set; }
         public bool WriteThrough { get; set; }
@@ -59,9 +89,90 @@ namespace ExxonMobil.IOBench.Core
 		public bool EnableRemotePrefetch { get; set; }
 		public bool NoOperationHints { get; set; }
 
+		// Priority hint given to every request through the file handle, and the average rate 
+		// the transfer is held to (0 for as fast as it can go). A shared file splits the rate 
+		// evenly among its sharers.
+		public IoPriority? IoPriority { get; set; }
+		public long RateBytesPerSec { get; set; }
+
+		// Transfers each block as one segment per system page with ReadFileScatter and 
+		// WriteFileGather. The handle is always overlapped, so synchronous loops issue each 
+		// request and wait for it.
+		public bool ScatterGather { get; set; }
+		public SegmentLayout SegmentLayout { get; set; }
+
+		// State of the system file cache for the file before a buffered read. Partial primes 
+		// CachePrimePercent of the blocks.
+		public CacheState CacheState { get; set; }
+		public int CachePrimePercent { get; set; }
+
 		public PreallocationType Preallocation { get; set; }
 		public WriteDataType WriteDataType { get; set; }
 
+		// Share of the requests of a write operation issued as trims, and the writes timed 
+		// before and after the trim pass of a trim operation.
+		public int TrimPercent { get; set; }
+		public TrimType TrimType { get; set; }
+		public int TrimProbeBlocks { get; set; }
+
+		public int MetadataDepth { get; set; }
+		public int MetadataFanout { get; set; }
+		public int MetadataFilesPerDirectory { get; set; }
+		public int MetadataThreads { get; set; }
+		public int MetadataPayloadBytes { get; set; }
+
+		public string TraceFilePath { get; set; }
+		public bool ReplayTimed { get; set; }
+		public double ReplayTimeScale { get; set; }
+
+		// An emulated device in place of the file. The null device completes without moving 
+		// data; the RAM device copies to and from memory the size of the file. Requests take 
+		// the modelled latency, with at most DeviceParallelism serviced at once (0 for no limit).
+		public DeviceType Device { get; set; }
+		public int DeviceParallelism { get; set; }
+		public LatencyModelType LatencyModel { get; set; }
+		public int LatencyMicroseconds { get; set; }
+		public int LatencyDeviationMicroseconds { get; set; }
+		public int StallsPerMillion { get; set; }
+		public int StallMicroseconds { get; set; }
+
+		// Sharers transfer one file at once, each through its own handle and thread. The file is 
+		// split into a segment per sharer or interleaved block by block. Requests can hold a 
+		// byte-range lock, and writes can append instead of landing at their offset.
+		public int Sharers { get; set; }
+		public SharedLayout SharedLayout { get; set; }
+		public bool LockRanges { get; set; }
+		public bool AppendWrites { get; set; }
+
+		// A multi-stream operation runs Streams sequential cursors over equal regions of the 
+		// file from one loop. Requests are dealt to the streams in turn or at random, and each 
+		// stream advances StreamStride blocks per request, backward when StreamReverse is set.
+		public int Streams { get; set; }
+		public StreamOrder StreamOrder { get; set; }
+		public int StreamStride { get; set; }
+		public bool StreamReverse { get; set; }
+
+		// A write-ahead log: Blocks records from WalProducers threads, committed in groups of at 
+		// most BlockSizeBytes that are padded to 4kB, written and flushed. A group waits up to 
+		// WalCommitMicroseconds after its first record for others to join it.
+		public int WalProducers { get; set; }
+		public RecordSizeModel WalRecordModel { get; set; }
+		public int WalRecordBytes { get; set; }
+		public int WalMinRecordBytes { get; set; }
+		public int WalMaxRecordBytes { get; set; }
+		public int WalCommitMicroseconds { get; set; }
+
+		// Conditioning written before the measured phase: sequential fills of the whole file, 
+		// then up to PreconditionRounds random overwrites of it that stop early once the write 
+		// rate is steady. A marker on the file skips it when the file is already conditioned.
+		public int PreconditionPasses { get; set; }
+		public int PreconditionRounds { get; set; }
+		public bool RepeatPrecondition { get; set; }
+
+		// A raw disk in place of the file. Writes to a disk that holds partitions are refused 
+		// unless forced.
+		public bool ForceDeviceWrites { get; set; }
+
 		public long FileSizeBytes
 		{
 			get 
@@ -69,12 +180,22 @@ namespace ExxonMobil.IOBench.Core
 				if (FilePerBlock)
 					return (long)BlockSizeBytes;
 				else
-					return (long)Blocks * (long)BlockSizeBytes; 
+					return Blocks * (long)BlockSizeBytes; 
 			}
 		}
 
 		public bool IsRead { get { return Operation == BenchmarkOperation.Read; } }
 		public bool IsWrite { get { return Operation == BenchmarkOperation.Write; } }
+		public bool IsTrim { get { return Operation == BenchmarkOperation.Trim; } }
+		public bool IsReplay { get { return AccessPattern == AccessPattern.Replay; } }
+		public bool IsMetadata { get { return AccessPattern == AccessPattern.Metadata; } }
+		public bool IsEmulated { get { return Device != DeviceType.File; } }
+		public bool IsSharedFile { get { return Sharers > 0; } }
+		public bool IsLog { get { return AccessPattern == AccessPattern.Log; } }
+		public bool IsPreconditioned { get { return PreconditionPasses > 0 || PreconditionRounds > 0; } }
+		public bool IsDevice { get { return !IsEmulated && RawDevice.IsDevicePath(FilePath); } }
+		public bool IsOverlapped { get { return Asynchronous || ScatterGather; } }
+		public bool IsMultiStream { get { return Streams > 0; } }
 
 		public bool Validate(ILogger logger = null)
 		{
@@ -91,11 +212,156 @@ namespace ExxonMobil.IOBench.Core
 				"Multi-file operations can not use preallocation.");
 
 			v.FailIf(() => AccessPattern == AccessPattern.Random && 
-				           (!VerifyPow2(Blocks) || Blocks < 4 || Blocks > 65536),
-				"Random access operations must use a block count that is between 4 and 65536 and is a power of 2.");
+				           (!VerifyPow2(Blocks) || Blocks < 4 || Blocks > MaxRandomBlocks),
+				"Random access operations must use a block count that is between 4 and 2^36 and is a power of 2.");
+			v.FailIf(() => AccessPattern == AccessPattern.Random && IsSharedFile && (!VerifyPow2(Sharers) || Blocks / Sharers < 4),
+				"Random shared file operations must use a power of 2 sharers with at least 4 blocks each.");
+
+			v.FailIf(() => IsReplay && String.IsNullOrWhiteSpace(TraceFilePath),
+				"Replay operations require a trace file.");
+			v.FailIf(() => IsReplay && (!Asynchronous || FilePerBlock || Preallocation != PreallocationType.None),
+				"Replay operations must be asynchronous and can not be combined with multi-file or preallocation options.");
+			v.FailIf(() => IsReplay && ReplayTimeScale <= 0,
+				"Replay time scale must be greater than 0.");
+
+			v.FailIf(() => IsTrim && (FilePerBlock || Preallocation != PreallocationType.None),
+				"Trim operations run over an existing file and can not be combined with multi-file or preallocation options.");
+			v.FailIf(() => TrimPercent < 0 || TrimPercent > 100,
+				"Trim mix must be between 0 and 100 percent.");
+			v.FailIf(() => TrimPercent > 0 && (!IsWrite || FilePerBlock || IsReplay || IsMetadata),
+				"A trim mix only applies to single file sequential and random write operations.");
+			v.FailIf(() => CacheState != CacheState.Default && (!IsRead || FilePerBlock || IsReplay || NoBuffering),
+				"Cache states only apply to buffered single file read operations.");
+			v.FailIf(() => CacheState == CacheState.Partial && (CachePrimePercent < 1 || CachePrimePercent > 99),
+				"Partial cache priming must be between 1 and 99 percent.");
+			v.FailIf(() => VerifyThreads < 0 || VerifyThreads > 64,
+				"Verifier threads must be between 0 and 64.");
+			v.FailIf(() => TrimProbeBlocks < 0,
+				"Write probe block count must be >=0.");
+
+			v.FailIf(() => IsMetadata && (Asynchronous || FilePerBlock || Preallocation != PreallocationType.None),
+				"Metadata operations are synchronous and can not be combined with multi-file or preallocation options.");
+			v.FailIf(() => IsMetadata && (MetadataDepth < 1 || MetadataDepth > 8 || MetadataFanout < 1 || MetadataFanout > 1000),
+				"Metadata tree depth must be between 1 and 8 and fanout between 1 and 1000.");
+			v.FailIf(() => IsMetadata && Math.Pow(MetadataFanout, MetadataDepth) * Math.Max(MetadataFilesPerDirectory, 1) > 10000000,
+				"Metadata tree can not hold more than 10,000,000 files.");
+			v.FailIf(() => IsMetadata && (MetadataFilesPerDirectory < 0 || MetadataThreads < 1 || MetadataThreads > 256),
+				"Metadata files per directory must be >=0 and threads between 1 and 256.");
+			v.FailIf(() => IsMetadata && (MetadataPayloadBytes < 0 || MetadataPayloadBytes > 1024 * 1024),
+				"Metadata payload must be between 0 and 1MB.");
+			v.FailIf(() => IsMetadata && File.Exists(FilePath),
+				"Metadata tree root must not already exist.");
+
+			v.FailIf(() => IsEmulated && (FilePerBlock || IsReplay || IsMetadata || IsTrim || TrimPercent > 0),
+				"Emulated devices only run sequential and random read and write operations.");
+			v.FailIf(() => IsEmulated && (Preallocation != PreallocationType.None || CacheState != CacheState.Default || AutoNumaNode),
+				"Emulated devices can not be combined with preallocation, cache state or automatic NUMA placement options.");
+			v.FailIf(() => Device == DeviceType.Null && ReadVerify,
+				"Reads from the null device return no data and can not be verified.");
+			v.FailIf(() => LatencyModel != LatencyModelType.None && !IsEmulated,
+				"Latency models only apply to emulated devices.");
+			v.FailIf(() => DeviceParallelism < 0 || DeviceParallelism > 256,
+				"Device parallelism must be between 0 and 256.");
+			v.FailIf(() => LatencyMicroseconds < 0 || LatencyDeviationMicroseconds < 0 || StallMicroseconds < 0,
+				"Latency model times must be >=0.");
+			v.FailIf(() => StallsPerMillion < 0 || StallsPerMillion > 1000000,
+				"Stalls per million requests must be between 0 and 1,000,000.");
+
+			v.FailIf(() => Sharers < 0 || Sharers > 64,
+				"Shared file sharers must be between 1 and 64.");
+			v.FailIf(() => IsSharedFile && (FilePerBlock || IsReplay || IsMetadata || IsEmulated || IsTrim || TrimPercent > 0),
+				"Shared file mode only runs sequential and random read and write operations on a file.");
+			v.FailIf(() => IsSharedFile && Blocks % Sharers != 0,
+				"Block count must divide evenly among the shared file sharers.");
+			v.FailIf(() => IsSharedFile && ReadVerify && Asynchronous && VerifyThreads > 0,
+				"Verifier threads can not be combined with shared file mode.");
+			v.FailIf(() => LockRanges && !IsSharedFile,
+				"Byte-range locks only apply to shared file mode.");
+			v.FailIf(() => AppendWrites && (!IsSharedFile || !IsWrite || AccessPattern != AccessPattern.Sequential),
+				"Appends only apply to sequential shared file writes.");
+			v.FailIf(() => AppendWrites && (LockRanges || Preallocation != PreallocationType.None),
+				"Appends can not be combined with byte-range locks or preallocation. They extend the file from empty.");
+
+			v.FailIf(() => IsLog && (FilePerBlock || Asynchronous || IsSharedFile || TrimPercent > 0 || Preallocation != PreallocationType.None),
+				"Log operations are synchronous appends to one file and can not be combined with -as, -shared, -tmix or preallocation.");
+			v.FailIf(() => IsLog && (WalProducers < 1 || WalProducers > 64),
+				"Log producers must be between 1 and 64.");
+			v.FailIf(() => IsLog && (WalMinRecordBytes < 1 || WalMinRecordBytes > WalMaxRecordBytes || WalMaxRecordBytes > BlockSizeBytes),
+				"Log record sizes must be at least 1 byte and no larger than the block size.");
+			v.FailIf(() => IsLog && WalRecordModel != RecordSizeModel.Uniform && (WalRecordBytes < WalMinRecordBytes || WalRecordBytes > WalMaxRecordBytes),
+				"Log record size must be within the record size bounds.");
+			v.FailIf(() => WalCommitMicroseconds < 0,
+				"Commit interval must be >=0.");
+
+			v.FailIf(() => PreconditionPasses < 0 || PreconditionPasses > 8 || PreconditionRounds < 0 || PreconditionRounds > 1000,
+				"Preconditioning takes between 0 and 8 sequential passes and between 0 and 1000 random rounds.");
+			v.FailIf(() => IsPreconditioned && (FilePerBlock || IsReplay || IsMetadata || IsEmulated || IsLog || IsTrim || AppendWrites),
+				"Preconditioning only applies to sequential and random read and write operations that overwrite a file in place.");
+			v.FailIf(() => PreconditionRounds > 0 && (!VerifyPow2(Blocks) || Blocks < 4 || Blocks > MaxRandomBlocks),
+				"Random preconditioning rounds must use a block count that is between 4 and 2^36 and is a power of 2.");
+			v.FailIf(() => IsPreconditioned && Preallocation != PreallocationType.None,
+				"Preconditioning allocates the whole file and can not be combined with preallocation.");
+			v.FailIf(() => RepeatPrecondition && !IsPreconditioned,
+				"Repeating preconditioning requires preconditioning.");
+
+			v.FailIf(() => IsDevice && (FilePerBlock || IsReplay || IsMetadata || IsLog || IsTrim || TrimPercent > 0 || AppendWrites),
+				"Raw devices only run sequential and random read and write operations.");
+			v.FailIf(() => IsDevice && (Preallocation != PreallocationType.None || CacheState != CacheState.Default || AutoNumaNode),
+				"Raw devices can not be combined with preallocation, cache states or automatic NUMA placement.");
+			v.FailIf(() => ForceDeviceWrites && !IsDevice,
+				"Forcing writes only applies to raw devices.");
+
+			v.FailIf(() => RateBytesPerSec < 0,
+				"Rate must be >=0.");
+			v.FailIf(() => RateBytesPerSec > 0 && (FilePerBlock || IsReplay || IsMetadata || IsLog || IsEmulated),
+				"Rate limits only apply to sequential and random operations on a file.");
+			v.FailIf(() => IoPriority.HasValue && (IsMetadata || IsEmulated),
+				"I/O priority only applies to operations on a file.");
+
+			v.FailIf(() => ScatterGather && (FilePerBlock || IsReplay || IsMetadata || IsLog || IsEmulated || IsTrim || TrimPercent > 0 || AppendWrites),
+				"Scatter/gather I/O only applies to sequential and random read and write operations on a file.");
+			v.FailIf(() => ScatterGather && !NoBuffering && !IsDevice,
+				"Scatter/gather I/O requires unbuffered I/O.");
+			v.FailIf(() => ScatterGather && BlockSizeBytes % Environment.SystemPageSize != 0,
+				"Scatter/gather I/O requires a block size that is a multiple of the system page size.");
+			v.FailIf(() => ScatterGather && ReadVerify && Asynchronous && VerifyThreads > 0,
+				"Verifier threads can not be combined with scatter/gather I/O.");
+			v.FailIf(() => SegmentLayout != SegmentLayout.Contiguous && !ScatterGather,
+				"Segment layouts only apply to scatter/gather I/O.");
+
+			v.FailIf(() => Streams < 0 || Streams > 64,
+				"Streams must be between 1 and 64.");
+			v.FailIf(() => StreamStride < 1,
+				"Stream stride must be at least 1 block.");
+			v.FailIf(() => IsMultiStream && (AccessPattern != AccessPattern.Sequential || FilePerBlock || IsEmulated || IsSharedFile || IsTrim || TrimPercent > 0),
+				"Streams only apply to single file sequential read and write operations and can not be combined with -shared or trims.");
+			v.FailIf(() => IsMultiStream && Blocks % ((long)Streams * StreamStride) != 0,
+				"Block count must divide evenly into streams and their stride.");
+			v.FailIf(() => !IsMultiStream && (StreamOrder != StreamOrder.RoundRobin || StreamStride != 1 || StreamReverse),
+				"Stream order, stride and direction only apply to multi-stream operations.");
 
 			v.FailIf(() => AsyncMaxBlocksOutstanding < 1 || AsyncMaxBlocksOutstanding > 256,
 				"Max outstanding asynchronous transfers must be between 1 and 256.");
+			v.FailIf(() => SubmitBatch < 1 || SubmitBatch > AsyncMaxBlocksOutstanding,
+				"Submit batch must be between 1 and max outstanding asynchronous transfers.");
+			v.FailIf(() => (SubmitBatch > 1 || AdaptiveSubmitBatch) && (!Asynchronous || IsReplay),
+				"Submit batching only applies to asynchronous sequential and random operations.");
+			v.FailIf(() => StrictAsync && (!Asynchronous || IsReplay || FilePerBlock),
+				"Strict asynchronous mode only applies to asynchronous sequential and random operations.");
+			v.FailIf(() => StrictAsync && !NoBuffering,
+				"Strict asynchronous mode requires unbuffered I/O.");
+			v.FailIf(() => StrictAsync && IsWrite && Preallocation == PreallocationType.None,
+				"Strict asynchronous writes require preallocation. Writes past the valid data length of a file complete synchronously.");
+			v.FailIf(() => CompletionMode != CompletionMode.Block && (!Asynchronous || IsReplay),
+				"Polled completion modes only apply to asynchronous sequential and random operations.");
+			v.FailIf(() => HybridSpinMicroseconds < 0,
+				"Hybrid polling time must be >=0.");
+			v.FailIf(() => NumaNode.HasValue && AutoNumaNode,
+				"A NUMA node can not be combined with automatic NUMA placement.");
+			v.FailIf(() => NumaNode < 0 || NumaNode > GetHighestNumaNode(),
+				"NUMA node must be between 0 and " + GetHighestNumaNode() + ".");
+			v.FailIf(() => CpuGroup < 0 || CpuGroup > ushort.MaxValue,
+				"Invalid processor group.");
 			v.FailIf(() => Blocks < 0,
 				"Block count must be >0.");
 			v.FailIf(() => BlockSizeBytes < 4 * 1024 || BlockSizeBytes > 8 * 1024 * 1024,
@@ -103,25 +369,37 @@ namespace ExxonMobil.IOBench.Core
 			v.FailIf(() => BlockSizeBytes % (4 * 1024) != 0,
 				"Block size must be a multiple of 4kB.");
 
-			v.FailIf(() => !IsValidPath(FilePath),
-				"Path must be to an existing file or a new file to create in an existing directory.");
+			v.FailIf(() => !IsEmulated && !IsValidPath(FilePath),
+				"Path must be to an existing file, a new file to create in an existing directory or a raw device.");
 
 			if (EnableRemotePrefetch)
 				logger.Log("Experimental option \"EnableRemotePrefetch\" is in use.", Category.Warn);
 
-			if (NoBuffering && IsNetworkPath(FilePath))
+			if (NoBuffering && !IsEmulated && !IsDevice && IsNetworkPath(FilePath))
 				logger.Log("Network transfer with -nb option. Performance will not be optimal.", Category.Warn);
 
 			return !v.HasIssues;
 		}
 
+		private static int GetHighestNumaNode()
+		{
+			uint highestNode;
+			if (!Win32Methods.GetNumaHighestNodeNumber(out highestNode))
+				return 0;
+			return (int)highestNode;
+		}
+
 		private bool IsNetworkPath(string FilePath)
 		{
 			return DfsHelpers.IsPathUnc(FilePath) || DfsHelpers.IsPathRootedOnNetworkDrive(FilePath);
 		}
 
+		// Device paths are only checked for their form here. The device itself is opened when 
+		// the benchmark is created.
 		private static bool IsValidPath(string path)
 		{
+			if (RawDevice.IsDevicePath(path))
+				return path.Length > 4;
 			if (Directory.Exists(path))
 				return false;
 			if (Directory.Exists(Path.GetDirectoryName(path)))
@@ -130,23 +408,51 @@ namespace ExxonMobil.IOBench.Core
 			return false;
 		}
 
-		private static bool VerifyPow2(int blocks)
+		private static bool VerifyPow2(long blocks)
 		{
-			var bitArray = new BitArray(new int[] { blocks });
-			return bitArray.Cast<bool>().Count(x => x) == 1;
+			return blocks > 0 && (blocks & (blocks - 1)) == 0;
 		}
+
+		// Widest sequence the native LFSR generates.
+		private const long MaxRandomBlocks = 1L << 36;
     }
 
 	public enum AccessPattern : uint
 	{
 		Sequential = 1,
-		Random     = 2
+		Random     = 2,
+		Replay     = 3,
+		Metadata   = 4,
+		Log        = 5
 	}
 
 	public enum BenchmarkOperation : uint
 	{
 		Write = 1,
-		Read = 2
+		Read = 2,
+		Trim = 3
+	}
+
+	public enum CompletionMode : uint
+	{
+		Block          = 0,
+		Poll           = 1,
+		Hybrid         = 2,
+		PollOverlapped = 3
+	}
+
+	public enum TrimType : uint
+	{
+		Punch   = 0,
+		Discard = 1
+	}
+
+	public enum CacheState
+	{
+		Default,
+		Cold,
+		Hot,
+		Partial
 	}
 
 	public enum PreallocationType
@@ -161,4 +467,52 @@ namespace ExxonMobil.IOBench.Core
 		Counter,
 		Random
 	}
+
+	public enum DeviceType : uint
+	{
+		File = 0,
+		Null = 1,
+		Ram  = 2
+	}
+
+	public enum LatencyModelType : uint
+	{
+		None     = 0,
+		Fixed    = 1,
+		Normal   = 2,
+		LongTail = 3
+	}
+
+	public enum SharedLayout : uint
+	{
+		Segment    = 0,
+		Interleave = 1
+	}
+
+	public enum RecordSizeModel : uint
+	{
+		Fixed       = 0,
+		Uniform     = 1,
+		Exponential = 2
+	}
+
+	public enum SegmentLayout : uint
+	{
+		Contiguous = 0,
+		Scattered  = 1
+	}
+
+	public enum StreamOrder : uint
+	{
+		RoundRobin = 0,
+		Random     = 1
+	}
+
+	// IO_PRIORITY_HINT values open to user mode.
+	public enum IoPriority : uint
+	{
+		VeryLow = 0,
+		Low     = 1,
+		Normal  = 2
+	}
 }
\ No newline at end of file
@@ -44,6 +44,33 @@ namespace ExxonMobil.IOBench.Core.Fluent
 			return bc;
 		}
 
+		public static BenchmarkConfiguration StrictlyAsynchronously(this BenchmarkConfiguration bc)
+		{
+			bc.Asynchronous = true;
+			bc.NoBuffering = true;
+			bc.StrictAsync = true;
+			return bc;
+		}
+
+		public static BenchmarkConfiguration SubmitInBatchesOf(this BenchmarkConfiguration bc, int batch)
+		{
+			bc.SubmitBatch = batch;
+			bc.AdaptiveSubmitBatch = false;
+			return bc;
+		}
+
+		public static BenchmarkConfiguration SubmitAdaptively(this BenchmarkConfiguration bc)
+		{
+			bc.AdaptiveSubmitBatch = true;
+			return bc;
+		}
+
+		public static BenchmarkConfiguration CompleteBy(this BenchmarkConfiguration bc, CompletionMode mode)
+		{
+			bc.CompletionMode = mode;
+			return bc;
+		}
+
 		public static BenchmarkConfiguration One(this BenchmarkConfiguration bc)
 		{
 			bc.FilePerBlock = false;
@@ -69,7 +96,7 @@ namespace ExxonMobil.IOBench.Core.Fluent
 			return bc;
 		}
 
-		public static BenchmarkConfiguration Blocks(this BenchmarkConfiguration bc, int blocks)
+		public static BenchmarkConfiguration Blocks(this BenchmarkConfiguration bc, long blocks)
 		{
 			bc.Blocks = blocks;
 			return bc;
@@ -93,6 +120,29 @@ namespace ExxonMobil.IOBench.Core.Fluent
 			return bc;
 		}
 
+		public static BenchmarkConfiguration Replay(this BenchmarkConfiguration bc, string tracePath)
+		{
+			bc.AccessPattern = AccessPattern.Replay;
+			bc.Asynchronous = true;
+			bc.TraceFilePath = tracePath;
+			return bc;
+		}
+
+		public static BenchmarkConfiguration Metadata(this BenchmarkConfiguration bc, int depth, int fanout, int filesPerDirectory)
+		{
+			bc.AccessPattern = AccessPattern.Metadata;
+			bc.MetadataDepth = depth;
+			bc.MetadataFanout = fanout;
+			bc.MetadataFilesPerDirectory = filesPerDirectory;
+			return bc;
+		}
+
+		public static BenchmarkConfiguration WithThreads(this BenchmarkConfiguration bc, int threads)
+		{
+			bc.MetadataThreads = threads;
+			return bc;
+		}
+
 		public static BenchmarkConfiguration Preallocated(this BenchmarkConfiguration bc)
 		{
 			bc.Preallocation = PreallocationType.Zeroed;
@@ -0,0 +1,51 @@
+﻿// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+namespace ExxonMobil.IOBench.Core
+{
+	// Cpu time, cycles and context switches charged to the thread driving the I/O, plus the time 
+	// and cycles of any verifier threads checking its reads. Intervals are accumulated so 
+	// multi-file runs report the total across every transfer.
+	public class CpuUsage
+	{
+		public TimeSpan UserTime { get; private set; }
+		public TimeSpan KernelTime { get; private set; }
+		public long Cycles { get; private set; }
+		public long ContextSwitches { get; private set; }
+
+		public TimeSpan TotalTime
+		{
+			get { return UserTime + KernelTime; }
+		}
+
+		internal void Accumulate(CpuSample start, CpuSample end)
+		{
+			UserTime += TimeSpan.FromTicks(end.Usage.UserTime - start.Usage.UserTime);
+			KernelTime += TimeSpan.FromTicks(end.Usage.KernelTime - start.Usage.KernelTime);
+			Cycles += end.Usage.Cycles - start.Usage.Cycles;
+			ContextSwitches += end.ContextSwitches - start.ContextSwitches;
+		}
+
+		internal void AccumulateThreads(NativeCpuUsage start, NativeCpuUsage end)
+		{
+			UserTime += TimeSpan.FromTicks(end.UserTime - start.UserTime);
+			KernelTime += TimeSpan.FromTicks(end.KernelTime - start.KernelTime);
+			Cycles += end.Cycles - start.Cycles;
+		}
+	}
+}
@@ -18,6 +18,8 @@ using System.Text;
 using System.IO;
 using System.Runtime.InteropServices;
 using System.ComponentModel;
+using System.Diagnostics;
+using System.Threading.Tasks;
 using Microsoft.Win32.SafeHandles;
 using ExxonMobil.Shared.Win32;
 
@@ -28,28 +30,343 @@ namespace ExxonMobil.IOBench.Core
 		public FileBenchmark(BenchmarkConfiguration config, bool enablePerfmon = true) :
 			base(config, enablePerfmon)
 		{
+			if (config.IsReplay)
+				LoadTrace();
+			if (config.IsLog)
+				bytesTotal = config.Blocks * MeanRecordBytes();
+			ResolveDevice();
+			ResolvePlacement();
+		}
+
+		// Everything up to the transfer: removing or checking the old file, preconditioning, 
+		// priming the cache and opening and sizing the handles the run then transfers through. 
+		// File per block runs create each file as part of the transfer.
+		protected override void PrepareRun()
+		{
+			if (config.IsEmulated)
+				return;
+
+			try
+			{
+				if (config.FilePerBlock)
+					PreMultiFileRun();
+				else if (config.IsReplay)
+					PrepareReplay();
+				else if (config.IsSharedFile)
+					PrepareSharedFile();
+				else if (config.IsLog)
+					PrepareLog();
+				else
+					PrepareSingleFile();
+			}
+			catch (Exception)
+			{
+				CloseHandles();
+				throw;
+			}
 		}
 
         protected override void Run()
         {
-			if (config.FilePerBlock)
-				MultiFileRun();
-			else
-				SingleFileRun();
+			try
+			{
+				if (config.IsEmulated)
+					EmulatedRun();
+				else if (config.FilePerBlock)
+					MultiFileRun();
+				else if (config.IsReplay)
+					ReplayRun();
+				else if (config.IsSharedFile)
+					SharedFileRun();
+				else if (config.IsLog)
+					LogRun();
+				else
+					SingleFileRun();
+			}
+			finally
+			{
+				CloseHandles();
+			}
         }
 
-		private unsafe void MultiFileRun()
+		private SafeFileHandle OpenHandle(string path)
+		{
+			var fileHandle = CreateFile(path);
+			handles.Add(fileHandle);
+			return fileHandle;
+		}
+
+		private void CloseHandles()
+		{
+			foreach (var handle in handles)
+				handle.Dispose();
+			handles.Clear();
+		}
+
+		private void LoadTrace()
+		{
+			trace = TraceFile.Load(config.TraceFilePath);
+			if (trace.MaxLength > MaxReplayLength)
+				throw new BenchmarkException("Trace contains requests larger than 8MB.");
+
+			config.Blocks = trace.Count;
+			config.BlockSizeBytes = (trace.MaxLength + ReplayBufferAlignment - 1) / ReplayBufferAlignment * ReplayBufferAlignment;
+			bytesTotal = trace.TotalBytes;
+			RecordedLatency = trace.RecordedLatency;
+		}
+
+		// A raw disk takes unbuffered requests of whole physical sectors, so the block size is 
+		// rounded up to one. Offsets are multiples of the block size and stay aligned unless the 
+		// disk reports its sectors start at an offset. Writes to a disk that holds partitions 
+		// would destroy them and are refused unless forced.
+		private void ResolveDevice()
+		{
+			if (!config.IsDevice)
+				return;
+
+			TargetDevice = RawDevice.Query(config.FilePath);
+			config.NoBuffering = true;
+
+			var sector = TargetDevice.PhysicalSectorBytes;
+			if (sector > 0 && config.BlockSizeBytes % sector != 0)
+			{
+				config.BlockSizeBytes = (config.BlockSizeBytes + sector - 1) / sector * sector;
+				bytesTotal = config.FileSizeBytes;
+			}
+
+			if (config.FileSizeBytes > TargetDevice.SizeBytes)
+				throw new BenchmarkException("The device '" + config.FilePath + "' is not large enough for this operation.")
+				{
+					HelpText = "The device holds " + TargetDevice.SizeBytes + " bytes. Reduce the block count or block size."
+				};
+
+			var writes = config.IsWrite || config.IsPreconditioned;
+			if (writes && TargetDevice.Partitions > 0 && !config.ForceDeviceWrites)
+				throw new BenchmarkException("The device '" + config.FilePath + "' holds " + TargetDevice.Partitions + " partition(s) and will not be written.")
+				{
+					HelpText = "Writing a raw device overwrites whatever is on it. Use -force to write it anyway. Windows still " +
+						"refuses writes to sectors of mounted volumes."
+				};
+		}
+
+		private void ResolvePlacement()
+		{
+			numaNode = NativeCore.NUMA_NO_PREFERRED_NODE;
+			if (config.AutoNumaNode)
+			{
+				int deviceNode;
+				if (NativeCore.GetDeviceNumaNode(Path.GetFullPath(config.FilePath), out deviceNode))
+				{
+					numaNode = deviceNode;
+					Placement = "Node " + deviceNode + " (auto)";
+				}
+				else
+					Placement = "None (device node unknown)";
+			}
+			else if (config.NumaNode.HasValue)
+			{
+				numaNode = config.NumaNode.Value;
+				Placement = "Node " + numaNode;
+			}
+
+			if (config.CpuMask != 0)
+			{
+				var cpus = String.Format("Group {0} CPUs 0x{1:X}", config.CpuGroup, config.CpuMask);
+				Placement = Placement == null ? cpus : Placement + ", " + cpus;
+			}
+		}
+
+		private NativeOpOptions CreateOpOptions()
+		{
+			return new NativeOpOptions
+			{
+				SubmitBatch = config.SubmitBatch,
+				AdaptiveBatch = config.AdaptiveSubmitBatch,
+				StrictAsync = config.StrictAsync,
+				CompletionMode = config.CompletionMode,
+				SpinMicroseconds = config.HybridSpinMicroseconds,
+				NumaNode = numaNode,
+				CpuGroup = config.CpuGroup,
+				CpuMask = config.CpuMask,
+				TrimPercent = config.TrimPercent,
+				TrimType = config.TrimType,
+				VerifyThreads = config.VerifyThreads,
+				Sharers = config.Sharers,
+				SharedLayout = config.SharedLayout,
+				LockRanges = config.LockRanges,
+				Append = config.AppendWrites,
+				RateBytesPerSec = config.IsSharedFile ? config.RateBytesPerSec / config.Sharers : config.RateBytesPerSec,
+				ScatterGather = config.ScatterGather,
+				SegmentLayout = config.SegmentLayout,
+				Streams = config.Streams,
+				StreamOrder = config.StreamOrder,
+				StreamStride = config.StreamStride,
+				StreamReverse = config.StreamReverse,
+				Device = new NativeEmulatedDevice
+				{
+					Type = config.Device,
+					Parallelism = config.DeviceParallelism,
+					Capacity = config.FileSizeBytes,
+					Latency = new NativeLatencyModel
+					{
+						Type = config.LatencyModel,
+						MeanMicroseconds = config.LatencyMicroseconds,
+						DeviationMicroseconds = config.LatencyDeviationMicroseconds,
+						StallsPerMillion = config.StallsPerMillion,
+						StallMicroseconds = config.StallMicroseconds
+					}
+				}
+			};
+		}
+
+		private void PrepareReplay()
 		{
-			PreMultiFileRun();
+			if (!trace.HasWrites && !File.Exists(config.FilePath))
+				throw new BenchmarkException("File to replay trace against not found.");
+
+			wallTime.Start();
+			var fileHandle = OpenHandle(config.FilePath);
+			long fileSize;
+			Win32Methods.GetFileSizeEx(fileHandle, out fileSize);
+			if (fileSize < trace.Extent)
+			{
+				if (!trace.HasWrites)
+					throw new BenchmarkException("The file '" + config.FilePath + "' is not large enough for this trace.")
+					{
+						HelpText = "The trace reads up to offset " + trace.Extent + ". Create a large enough file first " +
+							"with an iobench write operation."
+					};
+				NativeCore.SetFileSize(fileHandle, trace.Extent);
+			}
+			wallTime.Stop();
+		}
 
+		private unsafe void ReplayRun()
+		{
+			wallTime.Start();
+			var fileHandle = handles[0];
+			var cpuStart = NativeCore.BeginCpuSample();
+			StartTransferClock();
+			try
+			{
+				fixed (void* ptr = &status)
+				{
+					IntPtr pStatus = new IntPtr(ptr);
+					var options = CreateOpOptions();
+					if (!NativeCore.ReplayOp(fileHandle, trace.Records, trace.Count, config.BlockSizeBytes, config.ReplayTimed, config.ReplayTimeScale, config.AsyncMaxBlocksOutstanding, ref options, pStatus))
+						NativeCore.ThrowException();
+				}
+
+				if (trace.HasWrites && !config.DontFlushBuffers)
+				{
+					if (!Win32Methods.FlushFileBuffers(fileHandle))
+						throw new Win32Exception();
+				}
+			}
+			finally
+			{
+				StopTransferClock();
+			}
+			transferCpuUsage.Accumulate(cpuStart, NativeCore.EndCpuSample());
+			wallTime.Stop();
+		}
+
+		// The device in the options takes the place of the file, so the loops are given no handle.
+		private unsafe void EmulatedRun()
+		{
+			using (var noFile = new SafeFileHandle(new IntPtr(-1), false))
+			{
+				var cpuStart = NativeCore.BeginCpuSample();
+				var verifierCpuStart = status.VerifierCpu;
+				wallTime.Start();
+				StartTransferClock();
+				try
+				{
+					fixed (void* ptr = &status)
+					{
+						if (!Transfer(noFile, config.Operation, config.AccessPattern, config.Blocks, new IntPtr(ptr)))
+							NativeCore.ThrowException();
+					}
+				}
+				finally
+				{
+					StopTransferClock();
+					wallTime.Stop();
+				}
+				transferCpuUsage.Accumulate(cpuStart, NativeCore.EndCpuSample());
+				transferCpuUsage.AccumulateThreads(verifierCpuStart, status.VerifierCpu);
+			}
+		}
+
+		private long MeanRecordBytes()
+		{
+			if (config.WalRecordModel == RecordSizeModel.Uniform)
+				return (config.WalMinRecordBytes + config.WalMaxRecordBytes) / 2;
+			return config.WalRecordBytes;
+		}
+
+		private void PrepareLog()
+		{
+			PreSingleFileRun();
+			wallTime.Start();
+			OpenHandle(config.FilePath);
+			wallTime.Stop();
+		}
+
+		// Cpu usage is sampled on the writer thread; the producers are not included.
+		private unsafe void LogRun()
+		{
+			var wal = new NativeWalOptions
+			{
+				Records = config.Blocks,
+				Producers = config.WalProducers,
+				RecordModel = config.WalRecordModel,
+				RecordBytes = config.WalRecordBytes,
+				MinRecordBytes = config.WalMinRecordBytes,
+				MaxRecordBytes = config.WalMaxRecordBytes,
+				MaxGroupBytes = config.BlockSizeBytes,
+				CommitMicroseconds = config.WalCommitMicroseconds,
+				Flush = !config.DontFlushBuffers
+			};
+			var options = CreateOpOptions();
+
+			wallTime.Start();
+			var cpuStart = NativeCore.BeginCpuSample();
+			StartTransferClock();
+			try
+			{
+				fixed (void* ptr = &status)
+				{
+					NativeWalResult result;
+					if (!NativeCore.WalOp(handles[0], ref wal, ref options, new IntPtr(ptr), out result))
+						NativeCore.ThrowException();
+					LogCommits = result.Commits;
+					LogRecordBytes = result.RecordBytes;
+					LogPaddingBytes = result.PaddingBytes;
+				}
+			}
+			finally
+			{
+				StopTransferClock();
+			}
+			transferCpuUsage.Accumulate(cpuStart, NativeCore.EndCpuSample());
+			wallTime.Stop();
+		}
+
+		private unsafe void MultiFileRun()
+		{
             wallTime.Start();
-			for (int i = 0; i < config.Blocks; i++)
+			for (long i = 0; i < config.Blocks; i++)
 			{
 				if (status.Canceled)
 					return; 
 
 				var filePath = String.Format("{0}.{1:0000000}", config.FilePath, i);
-				RunTransfer(filePath, 1);
+				using (var fileHandle = CreateFile(filePath))
+				{
+					PrepareTransferFile(fileHandle);
+					RunTransfer(fileHandle, 1);
+				}
 			}
             wallTime.Stop();
 		}
@@ -79,77 +396,458 @@ namespace ExxonMobil.IOBench.Core
 			}
 		}
 
-		private void SingleFileRun()
+		private void PrepareSingleFile()
 		{
 			PreSingleFileRun();
+			Precondition(config.FilePath);
+			if (config.IsTrim)
+				WriteLatencyBeforeTrim = RunWriteProbe(config.FilePath);
+			PrepareCache(config.FilePath);
+			wallTime.Start();
+			PrepareTransferFile(OpenHandle(config.FilePath));
+			wallTime.Stop();
+		}
+
+		// The handle is closed before the probe after a trim, which opens the file again.
+		private void SingleFileRun()
+		{
+			SystemCacheBytesBefore = GetSystemCacheBytes();
             wallTime.Start();
-			RunTransfer(config.FilePath, config.Blocks);
+			RunTransfer(handles[0], config.Blocks);
+			CloseHandles();
             wallTime.Stop();
+			SystemCacheBytesAfter = GetSystemCacheBytes();
+			if (config.IsTrim)
+				WriteLatencyAfterTrim = RunWriteProbe(config.FilePath);
 		}
 
-		unsafe private void RunTransfer(string path, int blocks)
+		// Writes the whole file sequentially PreconditionPasses times, then overwrites it in random 
+		// order until the rate of the last few rounds stays within SteadyExcursion of their mean. 
+		// Every pass runs asynchronously and unbuffered at PreconditionDepth against a status of 
+		// its own, so none of it is counted in the measured phase.
+		private unsafe void Precondition(string path)
 		{
-			using (var fileHandle = CreateFile(path))
+			if (!config.IsPreconditioned)
+				return;
+
+			// A disk has no streams to hold a marker, so it is conditioned on every run.
+			if (!config.RepeatPrecondition && !config.IsDevice && File.Exists(path) && new FileInfo(path).Length >= config.FileSizeBytes)
 			{
-				if (config.IsWrite)
+				var existing = PreconditionMarker.Read(path);
+				if (existing != null && existing.Covers(config))
 				{
-					preallocTime.Start();
-					try
-					{
-						NativeCore.SetFileSize(fileHandle, config.FileSizeBytes);
-						if (config.Preallocation == PreallocationType.Zeroed)
-							NativeCore.PreallocateZerod(fileHandle, config.FileSizeBytes, config.Asynchronous);
-						else if (config.Preallocation == PreallocationType.Unzeroed)
-							NativeCore.PreallocateUnzerod(fileHandle, config.FileSizeBytes);
-					}
-					finally
-					{
-						preallocTime.Stop();
-					}
+					PreconditionState = existing;
+					PreconditionSkipped = true;
+					return;
 				}
-				else //config.IsRead == TRUE
+			}
+
+			var marker = new PreconditionMarker { SizeBytes = config.FileSizeBytes };
+			var rates = new List<double>();
+			var stopwatch = Stopwatch.StartNew();
+			fixed (void* ptr = &preconditionStatus)
+			{
+				var pStatus = new IntPtr(ptr);
+				for (int pass = 0; pass < config.PreconditionPasses && !preconditionStatus.Canceled; pass++)
+				{
+					PreconditionPass(path, AccessPattern.Sequential, pStatus);
+					marker.SequentialPasses++;
+				}
+
+				for (int round = 0; round < config.PreconditionRounds && !preconditionStatus.Canceled && !marker.Steady; round++)
+				{
+					rates.Add(config.FileSizeBytes / PreconditionPass(path, AccessPattern.Random, pStatus).TotalSeconds);
+					marker.RandomRounds++;
+					marker.Steady = IsSteady(rates);
+				}
+			}
+			PreconditionTime = stopwatch.Elapsed;
+			PreconditionRoundBytesPerSec = rates.ToArray();
+			if (preconditionStatus.Canceled)
+				return;
+
+			marker.Time = DateTime.UtcNow;
+			PreconditionState = marker;
+			PreconditionMarkerWritten = !config.IsDevice && marker.Write(path);
+		}
+
+		// Writes the whole file once in the given order and returns how long the writes took. 
+		// Every pass opens the file again: an asynchronous loop ties the handle it is given to a 
+		// completion port of its own, and a handle can only ever be tied to one.
+		private TimeSpan PreconditionPass(string path, AccessPattern accessPattern, IntPtr pStatus)
+		{
+			var share = config.IsDevice ? Win32FileShare.Read | Win32FileShare.Write : Win32FileShare.None;
+			var disposition = config.IsDevice ? Win32FileCreationDisposition.OpenExisting : Win32FileCreationDisposition.OpenAlways;
+			using (var fileHandle = Win32Methods.CreateFile(path, Win32FileAccess.GenericWrite, share, IntPtr.Zero,
+				disposition, Win32FileAttributes.Overlapped | Win32FileAttributes.NoBuffering, IntPtr.Zero))
+			{
+				if (fileHandle.IsInvalid)
+					throw new Win32Exception();
+				if (!config.IsDevice)
 				{
 					long fileSize;
 					Win32Methods.GetFileSizeEx(fileHandle, out fileSize);
 					if (fileSize < config.FileSizeBytes)
-						throw new BenchmarkException("The file '" + config.FilePath + "' is not large enough for this read operation.");
+						NativeCore.SetFileSize(fileHandle, config.FileSizeBytes);
 				}
 
-				transferTime.Start();
+				var randomData = config.WriteDataType == WriteDataType.Random;
+				var options = new NativeOpOptions
+				{
+					SubmitBatch = 1,
+					NumaNode = numaNode,
+					CpuGroup = config.CpuGroup,
+					CpuMask = config.CpuMask
+				};
+				var passTime = Stopwatch.StartNew();
+				if (!NativeCore.AsynchronousOp(fileHandle, BenchmarkOperation.Write, accessPattern, false, config.Blocks,
+					config.BlockSizeBytes, randomData, PreconditionDepth, ref options, pStatus))
+					NativeCore.ThrowException();
+				var elapsed = passTime.Elapsed;
+
+				if (!Win32Methods.FlushFileBuffers(fileHandle))
+					throw new Win32Exception();
+				return elapsed;
+			}
+		}
+
+		private static bool IsSteady(List<double> rates)
+		{
+			if (rates.Count < SteadyWindow)
+				return false;
+			var window = rates.Skip(rates.Count - SteadyWindow).ToList();
+			return window.Max() - window.Min() <= window.Average() * SteadyExcursion;
+		}
+
+		protected override void Cancel()
+		{
+			preconditionStatus.Canceled = true;
+			base.Cancel();
+		}
+
+		// Opening the file unbuffered flushes and purges its pages from the system cache. Hot and 
+		// partial states then read blocks back through the cache, with the read ahead hint 
+		// CreateFile would give that access pattern.
+		private void PrepareCache(string path)
+		{
+			if (config.CacheState == CacheState.Default)
+				return;
+
+			using (var fileHandle = Win32Methods.CreateFile(path, Win32FileAccess.GenericRead, Win32FileShare.Read, IntPtr.Zero,
+				Win32FileCreationDisposition.OpenExisting, Win32FileAttributes.NoBuffering, IntPtr.Zero))
+			{
+				if (fileHandle.IsInvalid)
+					throw new Win32Exception();
+			}
+
+			if (config.CacheState == CacheState.Hot)
+				PrimeCache(path, 100);
+			else if (config.CacheState == CacheState.Partial)
+				PrimeCache(path, config.CachePrimePercent);
+		}
+
+		private void PrimeCache(string path, int percent)
+		{
+			var options = percent == 100 ? FileOptions.SequentialScan : FileOptions.RandomAccess;
+			var buffer = new byte[config.BlockSizeBytes];
+			using (var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, 1, options))
+			{
+				// Primed blocks are spread evenly over the file.
+				for (long i = 0; i < config.Blocks && !status.Canceled; i++)
+				{
+					if (i * percent / 100 == (i + 1) * percent / 100)
+						continue;
+					stream.Position = i * config.BlockSizeBytes;
+					CachePrimedBytes += stream.Read(buffer, 0, buffer.Length);
+				}
+			}
+		}
+
+		private static long GetSystemCacheBytes()
+		{
+			var info = new PerformanceInformation();
+			info.Initialize();
+			if (!Win32Methods.GetPerformanceInfo(ref info, info.cb))
+				return 0;
+			return (long)info.SystemCache.ToUInt64() * (long)info.PageSize.ToUInt64();
+		}
+
+		// Times sequential writes over the start of the file outside of the transfer. Run 
+		// before and after the trim pass to show how large discards affect later writes.
+		private unsafe LatencyHistogram RunWriteProbe(string path)
+		{
+			if (config.TrimProbeBlocks == 0 || status.Canceled)
+				return null;
+
+			var probe = new NativeCoreStatus();
+			using (var fileHandle = CreateFile(path))
+			{
+				var blocks = Math.Min(config.TrimProbeBlocks, config.Blocks);
+				if (!Transfer(fileHandle, BenchmarkOperation.Write, AccessPattern.Sequential, blocks, new IntPtr(&probe)))
+					NativeCore.ThrowException();
+				if (!config.DontFlushBuffers && !Win32Methods.FlushFileBuffers(fileHandle))
+					throw new Win32Exception();
+			}
+			return LatencyHistogram.FromNative(ref probe.Latency);
+		}
+
+		private bool Transfer(SafeFileHandle fileHandle, BenchmarkOperation operation, AccessPattern accessPattern, long blocks, IntPtr pStatus, int sharer = 0)
+		{
+			var randomData = config.WriteDataType == WriteDataType.Random;
+			var options = CreateOpOptions();
+			options.Sharer = sharer;
+			if (config.Asynchronous)
+				return NativeCore.AsynchronousOp(fileHandle, operation, accessPattern, config.ReadVerify, blocks, config.BlockSizeBytes, randomData, config.AsyncMaxBlocksOutstanding, ref options, pStatus);
+			else
+				return NativeCore.SynchronousOp(fileHandle, operation, accessPattern, config.ReadVerify, blocks, config.BlockSizeBytes, randomData, ref options, pStatus);
+		}
+
+		// Sizes and preallocates a file to write, or checks a file to read or trim is large enough.
+		private void PrepareTransferFile(SafeFileHandle fileHandle)
+		{
+			if (config.IsWrite)
+			{
+				preallocTime.Start();
 				try
 				{
-					fixed (void* ptr = &status)
+					if (!config.IsDevice)
+						NativeCore.SetFileSize(fileHandle, config.FileSizeBytes);
+					if (config.Preallocation == PreallocationType.Zeroed)
+						NativeCore.PreallocateZerod(fileHandle, config.FileSizeBytes, config.IsOverlapped);
+					else if (config.Preallocation == PreallocationType.Unzeroed)
+						NativeCore.PreallocateUnzerod(fileHandle, config.FileSizeBytes);
+				}
+				finally
+				{
+					preallocTime.Stop();
+				}
+			}
+			else if (!config.IsDevice) //config.IsRead or config.IsTrim == TRUE
+			{
+				long fileSize;
+				Win32Methods.GetFileSizeEx(fileHandle, out fileSize);
+				if (fileSize < config.FileSizeBytes)
+					throw new BenchmarkException("The file '" + config.FilePath + "' is not large enough for this " + 
+						(config.IsTrim ? "trim" : "read") + " operation.");
+			}
+
+			if (config.IsTrim || config.TrimPercent > 0)
+				NativeCore.EnableTrim(fileHandle, config.TrimType, config.IsOverlapped);
+		}
+
+		unsafe private void RunTransfer(SafeFileHandle fileHandle, long blocks)
+		{
+			var cpuStart = NativeCore.BeginCpuSample();
+			var verifierCpuStart = status.VerifierCpu;
+			StartTransferClock();
+			try
+			{
+				fixed (void* ptr = &status)
+				{
+					if (!Transfer(fileHandle, config.Operation, config.AccessPattern, blocks, new IntPtr(ptr)))
+						NativeCore.ThrowException();
+				}
+				if (config.IsMultiStream)
+					ReadStreamResults();
+
+				if (config.Operation == BenchmarkOperation.Write && !config.DontFlushBuffers)
+				{
+					if (!Win32Methods.FlushFileBuffers(fileHandle))
+						throw new Win32Exception();
+				}
+			}
+			finally
+			{
+				StopTransferClock();
+			}
+			transferCpuUsage.Accumulate(cpuStart, NativeCore.EndCpuSample());
+			transferCpuUsage.AccumulateThreads(verifierCpuStart, status.VerifierCpu);
+		}
+
+		// Every sharer opens its own handle before any of them starts, and the file is created 
+		// and sized once through the first. Each sharer then transfers its share of the blocks on 
+		// its own thread, publishing to its own counter block.
+		private void PrepareSharedFile()
+		{
+			PreSingleFileRun();
+			Precondition(config.FilePath);
+			PrepareCache(config.FilePath);
+			wallTime.Start();
+
+			for (int i = 0; i < config.Sharers; i++)
+				OpenHandle(config.FilePath);
+
+			if (config.IsWrite && !config.AppendWrites && !config.IsDevice)
+			{
+				preallocTime.Start();
+				try
+				{
+					NativeCore.SetFileSize(handles[0], config.FileSizeBytes);
+					if (config.Preallocation == PreallocationType.Zeroed)
+						NativeCore.PreallocateZerod(handles[0], config.FileSizeBytes, config.IsOverlapped);
+					else if (config.Preallocation == PreallocationType.Unzeroed)
+						NativeCore.PreallocateUnzerod(handles[0], config.FileSizeBytes);
+				}
+				finally
+				{
+					preallocTime.Stop();
+				}
+			}
+			else if (config.IsRead && !config.IsDevice)
+			{
+				long fileSize;
+				Win32Methods.GetFileSizeEx(handles[0], out fileSize);
+				if (fileSize < config.FileSizeBytes)
+					throw new BenchmarkException("The file '" + config.FilePath + "' is not large enough for this read operation.");
+			}
+			wallTime.Stop();
+		}
+
+		private unsafe void SharedFileRun()
+		{
+			SystemCacheBytesBefore = GetSystemCacheBytes();
+			wallTime.Start();
+
+			var blocks = config.Blocks / config.Sharers;
+			var sharerTimes = new TimeSpan[config.Sharers];
+			var workers = new Task[config.Sharers];
+			StartTransferClock();
+			try
+			{
+				fixed (void* ptr = &status)
+				{
+					var pStatus = new IntPtr(ptr);
+					for (int s = 0; s < config.Sharers; s++)
 					{
-						bool retVal;
-						IntPtr pStatus = new IntPtr(ptr);
-						var randomData = config.WriteDataType == WriteDataType.Random;
-						if (config.Asynchronous)
-							retVal = NativeCore.AsynchronousOp(fileHandle, config.Operation, config.AccessPattern, config.ReadVerify, blocks, config.BlockSizeBytes, randomData, config.AsyncMaxBlocksOutstanding, pStatus);
-						else
-							retVal = NativeCore.SynchronousOp(fileHandle, config.Operation, config.AccessPattern, config.ReadVerify, blocks, config.BlockSizeBytes, randomData, pStatus);
-						if (!retVal)
-							NativeCore.ThrowException();
+						int sharer = s;
+						workers[sharer] = Task.Factory.StartNew(() =>
+						{
+							var stopwatch = Stopwatch.StartNew();
+							var cpuStart = NativeCore.BeginCpuSample();
+							try
+							{
+								if (!Transfer(handles[sharer], config.Operation, config.AccessPattern, blocks, pStatus, sharer))
+									NativeCore.ThrowException();
+								if (config.IsWrite && !config.DontFlushBuffers && !Win32Methods.FlushFileBuffers(handles[sharer]))
+									throw new Win32Exception();
+							}
+							catch (Exception)
+							{
+								// Stop the other sharers rather than leave them running to the end.
+								status.Canceled = true;
+								throw;
+							}
+							var cpuEnd = NativeCore.EndCpuSample();
+							sharerTimes[sharer] = stopwatch.Elapsed;
+							lock (transferCpuUsage)
+								transferCpuUsage.Accumulate(cpuStart, cpuEnd);
+						}, TaskCreationOptions.LongRunning);
 					}
 
-					if (config.Operation == BenchmarkOperation.Write && !config.DontFlushBuffers)
+					try
 					{
-						if (!Win32Methods.FlushFileBuffers(fileHandle))
-							throw new Win32Exception();
+						Task.WaitAll(workers);
+					}
+					catch (AggregateException e)
+					{
+						throw e.Flatten().InnerExceptions.First();
 					}
 				}
-				finally
+			}
+			finally
+			{
+				StopTransferClock();
+			}
+
+			SharerBytesPerSec = sharerTimes
+				.Select((time, sharer) => time.Ticks == 0 ? 0 : (long)(GetWorkerCounters(sharer).BytesTransferred / time.TotalSeconds))
+				.ToArray();
+			CloseHandles();
+
+			wallTime.Stop();
+			SystemCacheBytesAfter = GetSystemCacheBytes();
+		}
+
+		// Each stream's rate is taken over the time to its own last completion, so a stream 
+		// starved by random dealing or slow to prefetch shows up below its share.
+		private unsafe void ReadStreamResults()
+		{
+			StreamBytesPerSec = new long[config.Streams];
+			StreamLatencyMeanMicroseconds = new double[config.Streams];
+			fixed (long* bytes = status.StreamBytes)
+			fixed (long* latencies = status.StreamLatencyMicroseconds)
+			fixed (long* finishes = status.StreamFinishMicroseconds)
+			{
+				for (int i = 0; i < config.Streams; i++)
 				{
-					transferTime.Stop();
+					long requests = bytes[i] / config.BlockSizeBytes;
+					StreamBytesPerSec[i] = finishes[i] == 0 ? 0 : (long)(bytes[i] / (finishes[i] / 1000000.0));
+					StreamLatencyMeanMicroseconds[i] = requests == 0 ? 0 : (double)latencies[i] / requests;
 				}
 			}
 		}
 
 		private void PreSingleFileRun()
 		{
-			if (config.IsWrite && File.Exists(config.FilePath))
+			if (config.IsDevice)
+				return;
+			if (config.IsWrite && File.Exists(config.FilePath) && !config.IsPreconditioned)
 				File.Delete(config.FilePath);
-			else if (config.IsRead && !File.Exists(config.FilePath))
+			else if (config.IsRead && !File.Exists(config.FilePath) && !config.IsPreconditioned)
 				throw new BenchmarkException("File to read not found.");
+			else if (config.IsTrim && !File.Exists(config.FilePath))
+				throw new BenchmarkException("File to trim not found.")
+				{
+					HelpText = "Trim operations discard blocks of an existing file. Create the file first with an iobench write operation."
+				};
 		}
+
+		// The raw disk the benchmark runs against, or null for a file.
+		public RawDevice TargetDevice { get; private set; }
+
+		// Average throughput of each sharer over its own transfer in a shared file run, or null.
+		public long[] SharerBytesPerSec { get; private set; }
+
+		// Throughput and mean request latency of each stream of a multi-stream run, or null.
+		public long[] StreamBytesPerSec { get; private set; }
+		public double[] StreamLatencyMeanMicroseconds { get; private set; }
+
+		// Groups committed by a log run and the record and padding bytes they wrote.
+		public long LogCommits { get; private set; }
+		public long LogRecordBytes { get; private set; }
+		public long LogPaddingBytes { get; private set; }
+
+		public double LogCommitsPerSec
+		{
+			get
+			{
+				double seconds = transferTime.Elapsed.TotalSeconds;
+				return seconds == 0 ? 0 : LogCommits / seconds;
+			}
+		}
+
+		public double LogAverageGroupRecords
+		{
+			get { return LogCommits == 0 ? 0 : (double)BlocksTransferred / LogCommits; }
+		}
+
+		// How the file was conditioned before the measured phase, or null when it was not. When 
+		// skipped, the marker already on the file.
+		public PreconditionMarker PreconditionState { get; private set; }
+		public bool PreconditionSkipped { get; private set; }
+		public bool PreconditionMarkerWritten { get; private set; }
+		public TimeSpan PreconditionTime { get; private set; }
+		public double[] PreconditionRoundBytesPerSec { get; private set; }
+
+		private const int PreconditionDepth = 32;
+		private const int SteadyWindow = 3;
+		private const double SteadyExcursion = 0.2;
+		private const int MaxReplayLength = 8 * 1024 * 1024;
+		private const int ReplayBufferAlignment = 4 * 1024;
+		private TraceFile trace;
+		private int numaNode;
+		private NativeCoreStatus preconditionStatus;
+		// Opened by PrepareRun and closed once the run is over.
+		private readonly List<SafeFileHandle> handles = new List<SafeFileHandle>();
     }
 }
@@ -0,0 +1,108 @@
+﻿// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace ExxonMobil.IOBench.Core
+{
+	// A named workload among several run against the same storage at once.
+	public class JobGroup
+	{
+		public JobGroup(string name, BenchmarkConfiguration config)
+		{
+			Name = name;
+			Config = config;
+		}
+
+		public string Name { get; private set; }
+		public BenchmarkConfiguration Config { get; private set; }
+
+		// A protected group is the one whose latency is being defended. It is run alone first, 
+		// and its solo run is kept as Baseline.
+		public bool Protected { get; set; }
+		public Benchmark Baseline { get; internal set; }
+		public Benchmark Mixed { get; internal set; }
+	}
+
+	public enum JobGroupPhase
+	{
+		NotStarted,
+		Baseline,
+		Mixed
+	}
+
+	// Runs every group at the same time, each as a benchmark of its own. With a protected 
+	// group the mixed phase ends for all of them when it finishes, so everything it measures 
+	// was measured under interference and the other groups report only the overlap.
+	public class JobGroupRun
+	{
+		public JobGroupRun(IList<JobGroup> groups)
+		{
+			Groups = groups;
+		}
+
+		public IList<JobGroup> Groups { get; private set; }
+		public JobGroupPhase Phase { get; private set; }
+
+		public JobGroup ProtectedGroup
+		{
+			get { return Groups.FirstOrDefault(g => g.Protected); }
+		}
+
+		public Task Start(CancellationToken token)
+		{
+			return Task.Factory.StartNew(() => Run(token), token, TaskCreationOptions.LongRunning, TaskScheduler.Default);
+		}
+
+		private void Run(CancellationToken token)
+		{
+			var protectedGroup = ProtectedGroup;
+			if (protectedGroup != null)
+			{
+				Phase = JobGroupPhase.Baseline;
+				protectedGroup.Baseline = Benchmark.Create(protectedGroup.Config);
+				Wait(new[] { protectedGroup.Baseline.Start(token) }, token);
+			}
+
+			Phase = JobGroupPhase.Mixed;
+			foreach (var group in Groups)
+				group.Mixed = Benchmark.Create(group.Config);
+			var tasks = Groups.Select(g => g.Mixed.Start(token)).ToArray();
+
+			if (protectedGroup != null)
+			{
+				((IAsyncResult)tasks[Groups.IndexOf(protectedGroup)]).AsyncWaitHandle.WaitOne();
+				foreach (var group in Groups.Where(g => g != protectedGroup))
+					group.Mixed.Stop();
+			}
+			Wait(tasks, token);
+		}
+
+		private static void Wait(Task[] tasks, CancellationToken token)
+		{
+			try
+			{
+				Task.WaitAll(tasks);
+			}
+			catch (AggregateException e)
+			{
+				token.ThrowIfCancellationRequested();
+				throw e.Flatten().InnerExceptions.First();
+			}
+		}
+	}
+}
@@ -0,0 +1,152 @@
+﻿// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+namespace ExxonMobil.IOBench.Core
+{
+	// Log-linear histogram of latencies in microseconds. The bucket layout matches the 
+	// native LatencyHistogram so native counts can be copied in directly.
+	public class LatencyHistogram
+	{
+		public const int BucketCount = 256;
+		private const int LinearBuckets = 16;
+		private const int SubBucketBits = 3;
+
+		private readonly long[] buckets = new long[BucketCount];
+
+		public long Count
+		{
+			get { return buckets.Sum(); }
+		}
+
+		public void Record(long microseconds)
+		{
+			buckets[GetBucket(microseconds)]++;
+		}
+
+		public void Merge(LatencyHistogram other)
+		{
+			for (int i = 0; i < BucketCount; i++)
+				buckets[i] += other.buckets[i];
+		}
+
+		// Bucket counts, for moving a histogram between processes. Merging the counts, rather 
+		// than averaging quantiles, keeps the quantiles of the merged histogram exact.
+		public long[] ToArray()
+		{
+			return (long[])buckets.Clone();
+		}
+
+		public static LatencyHistogram FromArray(long[] counts)
+		{
+			if (counts.Length != BucketCount)
+				throw new ArgumentException("A latency histogram has " + BucketCount + " buckets.", "counts");
+			var histogram = new LatencyHistogram();
+			Array.Copy(counts, histogram.buckets, BucketCount);
+			return histogram;
+		}
+
+		// Latencies recorded since an earlier copy of this histogram was taken.
+		public LatencyHistogram Since(LatencyHistogram earlier)
+		{
+			var interval = new LatencyHistogram();
+			for (int i = 0; i < BucketCount; i++)
+				interval.buckets[i] = buckets[i] - earlier.buckets[i];
+			return interval;
+		}
+
+		// Upper bound in microseconds of the bucket holding the quantile (0-1).
+		public long Quantile(double quantile)
+		{
+			long count = Count;
+			if (count == 0)
+				return 0;
+
+			long target = (long)Math.Ceiling(quantile * count);
+			if (target < 1)
+				target = 1;
+
+			long seen = 0;
+			for (int i = 0; i < BucketCount; i++)
+			{
+				seen += buckets[i];
+				if (seen >= target)
+					return GetBucketUpperBound(i);
+			}
+			return GetBucketUpperBound(BucketCount - 1);
+		}
+
+		public double MeanMicroseconds
+		{
+			get
+			{
+				long count = Count;
+				if (count == 0)
+					return 0;
+
+				double sum = 0;
+				for (int i = 0; i < BucketCount; i++)
+					sum += buckets[i] * (GetBucketLowerBound(i) + GetBucketUpperBound(i)) / 2.0;
+				return sum / count;
+			}
+		}
+
+		internal static unsafe LatencyHistogram FromNative(ref NativeLatencyHistogram native)
+		{
+			var histogram = new LatencyHistogram();
+			fixed (long* pBuckets = native.Buckets)
+			{
+				for (int i = 0; i < BucketCount; i++)
+					histogram.buckets[i] = pBuckets[i];
+			}
+			return histogram;
+		}
+
+		internal static int GetBucket(long microseconds)
+		{
+			if (microseconds < LinearBuckets)
+				return microseconds < 0 ? 0 : (int)microseconds;
+
+			int msb = 0;
+			long value = microseconds;
+			while ((value >>= 1) != 0) ++msb;
+
+			int subBucket = (int)(microseconds >> (msb - SubBucketBits)) & ((1 << SubBucketBits) - 1);
+			int bucket = LinearBuckets + ((msb - 4) << SubBucketBits) + subBucket;
+			return Math.Min(bucket, BucketCount - 1);
+		}
+
+		internal static long GetBucketLowerBound(int bucket)
+		{
+			if (bucket < LinearBuckets)
+				return bucket;
+
+			int msb = ((bucket - LinearBuckets) >> SubBucketBits) + 4;
+			long subBucket = (bucket - LinearBuckets) & ((1 << SubBucketBits) - 1);
+			return ((1L << SubBucketBits) + subBucket) << (msb - SubBucketBits);
+		}
+
+		internal static long GetBucketUpperBound(int bucket)
+		{
+			if (bucket < LinearBuckets)
+				return bucket + 1;
+
+			int msb = ((bucket - LinearBuckets) >> SubBucketBits) + 4;
+			return GetBucketLowerBound(bucket) + (1L << (msb - SubBucketBits));
+		}
+	}
+}
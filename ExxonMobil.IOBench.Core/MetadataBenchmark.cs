@@ -0,0 +1,246 @@
+﻿// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.IO;
+using System.Diagnostics;
+using System.Threading;
+using System.Threading.Tasks;
+using System.ComponentModel;
+using System.Runtime.InteropServices;
+using Microsoft.Win32.SafeHandles;
+using ExxonMobil.Shared.Win32;
+
+namespace ExxonMobil.IOBench.Core
+{
+	// Builds a directory tree of MetadataDepth levels with MetadataFanout subdirectories per 
+	// level and MetadataFilesPerDirectory files in each leaf, then times each metadata 
+	// operation over the whole tree with MetadataThreads threads.
+	public class MetadataBenchmark : Benchmark
+	{
+		public MetadataBenchmark(BenchmarkConfiguration config, bool enablePerfmon = true) :
+			base(config, enablePerfmon)
+		{
+			BuildTree();
+			config.Blocks = directories.Count * 2 + files.Count * 5;
+			bytesTotal = (long)files.Count * config.MetadataPayloadBytes;
+			payload = new byte[config.MetadataPayloadBytes];
+			Phases = new List<MetadataPhase>();
+		}
+
+		public IList<MetadataPhase> Phases { get; private set; }
+
+		protected override void PrepareRun()
+		{
+			if (!Win32Methods.CreateDirectory(config.FilePath, IntPtr.Zero))
+				throw new Win32Exception();
+		}
+
+		protected override void Run()
+		{
+			wallTime.Start();
+			StartTransferClock();
+			try
+			{
+				// Parents must exist before their children so directories are made a level at a time.
+				RunPhase("mkdir", directories.GroupBy(d => d.Level).OrderBy(g => g.Key).Select(g => g.Select(d => d.Path).ToList()), MakeDirectory);
+				RunPhase("create", new[] { files }, CreateTreeFile, payload.Length);
+				RunPhase("stat", new[] { files }, StatFile);
+				RunPhase("open", new[] { files }, OpenCloseFile);
+				RunPhase("rename", new[] { files }, RenameFile);
+				RunPhase("unlink", new[] { files }, f => DeleteFile(f + RenameSuffix));
+				RunPhase("rmdir", directories.GroupBy(d => d.Level).OrderByDescending(g => g.Key).Select(g => g.Select(d => d.Path).ToList()), RemoveDirectory);
+			}
+			finally
+			{
+				StopTransferClock();
+				wallTime.Stop();
+			}
+
+			if (!status.Canceled)
+				Win32Methods.RemoveDirectory(config.FilePath);
+		}
+
+		private void BuildTree()
+		{
+			var level = new List<string> { config.FilePath };
+			for (int depth = 1; depth <= config.MetadataDepth; depth++)
+			{
+				var next = new List<string>();
+				foreach (var parent in level)
+				{
+					for (int i = 0; i < config.MetadataFanout; i++)
+					{
+						var path = Path.Combine(parent, "d" + i.ToString("0000"));
+						directories.Add(new TreeDirectory { Path = path, Level = depth });
+						next.Add(path);
+					}
+				}
+				level = next;
+			}
+
+			foreach (var leaf in level)
+				for (int i = 0; i < config.MetadataFilesPerDirectory; i++)
+					files.Add(Path.Combine(leaf, "f" + i.ToString("000000")));
+		}
+
+		// Runs each step to completion before starting the next. Items in a step are split 
+		// across the worker threads, each keeping its own histogram.
+		private void RunPhase(string name, IEnumerable<List<string>> steps, Action<string> operation, long bytesPerItem = 0)
+		{
+			if (status.Canceled)
+				return;
+
+			var phase = new MetadataPhase(name);
+			var stopwatch = Stopwatch.StartNew();
+			foreach (var items in steps)
+			{
+				int threads = Math.Min(config.MetadataThreads, items.Count);
+				var histograms = new LatencyHistogram[threads];
+				var workers = new Task[threads];
+				for (int t = 0; t < threads; t++)
+				{
+					int thread = t;
+					histograms[thread] = new LatencyHistogram();
+					workers[thread] = Task.Factory.StartNew(() =>
+					{
+						for (int i = thread; i < items.Count && !status.Canceled; i += threads)
+						{
+							long start = Stopwatch.GetTimestamp();
+							operation(items[i]);
+							histograms[thread].Record((Stopwatch.GetTimestamp() - start) * 1000000 / Stopwatch.Frequency);
+							AddProgress(thread, 1, bytesPerItem);
+						}
+					}, TaskCreationOptions.LongRunning);
+				}
+
+				try
+				{
+					Task.WaitAll(workers);
+				}
+				catch (AggregateException e)
+				{
+					throw e.Flatten().InnerExceptions.First();
+				}
+
+				foreach (var histogram in histograms)
+					phase.Latency.Merge(histogram);
+			}
+			stopwatch.Stop();
+
+			phase.Elapsed = stopwatch.Elapsed;
+			Phases.Add(phase);
+		}
+
+		private void MakeDirectory(string path)
+		{
+			if (!Win32Methods.CreateDirectory(path, IntPtr.Zero))
+				ThrowOperationException("create directory", path);
+		}
+
+		private void CreateTreeFile(string path)
+		{
+			using (var handle = Win32Methods.CreateFile(path, Win32FileAccess.GenericWrite, Win32FileShare.None, IntPtr.Zero, 
+				Win32FileCreationDisposition.New, Win32FileAttributes.Normal, IntPtr.Zero))
+			{
+				if (handle.IsInvalid)
+					ThrowOperationException("create", path);
+				if (payload.Length > 0)
+				{
+					using (var stream = new FileStream(handle, FileAccess.Write, 1))
+						stream.Write(payload, 0, payload.Length);
+				}
+			}
+		}
+
+		private void StatFile(string path)
+		{
+			Win32FileAttributeData data;
+			if (!Win32Methods.GetFileAttributesEx(path, GetFileExInfoStandard, out data))
+				ThrowOperationException("stat", path);
+		}
+
+		private void OpenCloseFile(string path)
+		{
+			using (var handle = Win32Methods.CreateFile(path, Win32FileAccess.GenericRead, Win32FileShare.Read, IntPtr.Zero,
+				Win32FileCreationDisposition.OpenExisting, Win32FileAttributes.Normal, IntPtr.Zero))
+			{
+				if (handle.IsInvalid)
+					ThrowOperationException("open", path);
+			}
+		}
+
+		private void RenameFile(string path)
+		{
+			if (!Win32Methods.MoveFileEx(path, path + RenameSuffix, 0))
+				ThrowOperationException("rename", path);
+		}
+
+		private void DeleteFile(string path)
+		{
+			if (!Win32Methods.DeleteFile(path))
+				ThrowOperationException("delete", path);
+		}
+
+		private void RemoveDirectory(string path)
+		{
+			if (!Win32Methods.RemoveDirectory(path))
+				ThrowOperationException("remove directory", path);
+		}
+
+		private static void ThrowOperationException(string operation, string path)
+		{
+			var win32ex = new Win32Exception();
+			throw new BenchmarkException("Failed to " + operation + " '" + path + "'.", win32ex);
+		}
+
+		private class TreeDirectory
+		{
+			public string Path;
+			public int Level;
+		}
+
+		private const string RenameSuffix = ".renamed";
+		private const int GetFileExInfoStandard = 0;
+
+		private readonly List<TreeDirectory> directories = new List<TreeDirectory>();
+		private readonly List<string> files = new List<string>();
+		private readonly byte[] payload;
+	}
+
+	public class MetadataPhase
+	{
+		public MetadataPhase(string name)
+		{
+			Name = name;
+			Latency = new LatencyHistogram();
+		}
+
+		public string Name { get; private set; }
+		public TimeSpan Elapsed { get; internal set; }
+		public LatencyHistogram Latency { get; private set; }
+
+		public long Operations
+		{
+			get { return Latency.Count; }
+		}
+
+		public double OperationsPerSec
+		{
+			get { return Elapsed.TotalSeconds == 0 ? 0 : Operations / Elapsed.TotalSeconds; }
+		}
+	}
+}
@@ -27,6 +27,9 @@ namespace ExxonMobil.IOBench.Core
 		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, SetLastError = true)]
 		public static extern bool DisableLocalBuffering(SafeFileHandle hFile, bool async);
 
+		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, SetLastError = true)]
+		public static extern bool SetIoPriorityHint(SafeFileHandle hFile, IoPriority priority);
+
 		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, SetLastError = true)]
 		public static extern bool Experimental_EnableRemotePrefetch(SafeFileHandle hFile, bool async);
 
@@ -34,10 +37,31 @@ namespace ExxonMobil.IOBench.Core
 		public static extern bool PreallocZeroed(SafeFileHandle hFile, long fileSize, bool async);
 
 		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, SetLastError = true)]
-		public static extern bool AsynchronousOp(SafeFileHandle hFile, BenchmarkOperation operation, AccessPattern accessPattern, bool verify, int blocks, int blockSize, bool randomData, int maxOutstanding, IntPtr status);
+		public static extern bool PrepareTrim(SafeFileHandle hFile, TrimType trimType, bool async);
+
+		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, SetLastError = true)]
+		public static extern bool AsynchronousOp(SafeFileHandle hFile, BenchmarkOperation operation, AccessPattern accessPattern, bool verify, long blocks, int blockSize, bool randomData, int maxOutstanding, ref NativeOpOptions options, IntPtr status);
+
+		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, SetLastError = true)]
+		public static extern bool SynchronousOp(SafeFileHandle hFile, BenchmarkOperation operation, AccessPattern accessPattern, bool verify, long blocks, int blockSize, bool randomData, ref NativeOpOptions options, IntPtr status);
+
+		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, SetLastError = true)]
+		public static extern bool ReplayOp(SafeFileHandle hFile, [In] ReplayRecord[] records, int recordCount, int maxLength, bool timed, double timeScale, int maxOutstanding, ref NativeOpOptions options, IntPtr status);
+
+		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, SetLastError = true)]
+		public static extern bool WalOp(SafeFileHandle hFile, ref NativeWalOptions wal, ref NativeOpOptions options, IntPtr status, out NativeWalResult result);
+
+		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode, SetLastError = true)]
+		public static extern bool GetDeviceNumaNode(string path, out int numaNode);
+
+		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode, SetLastError = true)]
+		public static extern bool GetDeviceInfo(string path, out NativeDeviceInfo info);
+
+		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, SetLastError = true)]
+		public static extern bool GetThreadCpuUsage(out NativeCpuUsage usage);
 
 		[DllImport("ExxonMobil.IOBench.NativeCore.dll", CallingConvention = CallingConvention.Cdecl, SetLastError = true)]
-		public static extern bool SynchronousOp(SafeFileHandle hFile, BenchmarkOperation operation, AccessPattern accessPattern, bool verify, int blocks, int blockSize, bool randomData, IntPtr status);
+		public static extern bool GetThreadContextSwitches(out long contextSwitches);
 
 		public static void ThrowException()
 		{
@@ -76,6 +100,42 @@ namespace ExxonMobil.IOBench.Core
 			}
 		}
 
+		// Samples the cpu usage of the calling thread. The context switch count is taken first on 
+		// the way in and last on the way out so the cost of querying it stays outside the interval.
+		public static CpuSample BeginCpuSample()
+		{
+			var sample = new CpuSample();
+			if (!GetThreadContextSwitches(out sample.ContextSwitches) || !GetThreadCpuUsage(out sample.Usage))
+				ThrowCpuSampleException();
+			return sample;
+		}
+
+		public static CpuSample EndCpuSample()
+		{
+			var sample = new CpuSample();
+			if (!GetThreadCpuUsage(out sample.Usage) || !GetThreadContextSwitches(out sample.ContextSwitches))
+				ThrowCpuSampleException();
+			return sample;
+		}
+
+		private static void ThrowCpuSampleException()
+		{
+			var win32ex = new Win32Exception();
+			throw new BenchmarkException("Could not sample thread cpu usage.", win32ex);
+		}
+
+		public static void EnableTrim(SafeFileHandle fileHandle, TrimType trimType, bool isAsync)
+		{
+			if (!NativeCore.PrepareTrim(fileHandle, trimType, isAsync))
+			{
+				var win32ex = new Win32Exception();
+				throw new BenchmarkException("Could not make the file sparse for hole punching.", win32ex)
+				{
+					HelpText = "Punching holes requires a file system with sparse file support such as NTFS."
+				};
+			}
+		}
+
 		public static void SetFileSize(SafeFileHandle fileHandle, long sizeBytes)
 		{
 			if (!Win32Methods.SetFilePointerEx(fileHandle, sizeBytes, IntPtr.Zero, System.IO.SeekOrigin.Begin))
@@ -84,19 +144,201 @@ namespace ExxonMobil.IOBench.Core
 				throw new Win32Exception();
 		}
 
+		public const int NUMA_NO_PREFERRED_NODE = -1;
+		public const int STATUS_MAX_WORKERS = 65; // the transfer loop plus up to 64 verifier threads
+		public const int STATUS_MAX_STREAMS = 64;
 		private const int ERROR_CRC = 0x00000017;
     }
 
 	[StructLayout(LayoutKind.Sequential)]
-	struct NativeCoreStatus
+	unsafe struct NativeCoreStatus
 	{
 		public volatile bool Canceled;
+		private int Reserved;
+
+		public long VerifyBacklog;
+		public long VerifyBacklogPeak;
+		public NativeLatencyHistogram Latency;
+		public NativeLatencyHistogram TrimLatency;
 
-		public volatile int BlocksTransferred;
-		public volatile int CompletedAsync;
-		public volatile int CompletedSync;
+		public NativeCpuUsage VerifierCpu;
+
+		public fixed long StreamBytes[NativeCore.STATUS_MAX_STREAMS];
+		public fixed long StreamLatencyMicroseconds[NativeCore.STATUS_MAX_STREAMS];
+		public fixed long StreamFinishMicroseconds[NativeCore.STATUS_MAX_STREAMS];
+
+		// NativeStatBlock[STATUS_MAX_WORKERS]; fixed buffers can only hold primitive types.
+		public fixed byte Workers[NativeStatBlock.Size * NativeCore.STATUS_MAX_WORKERS];
+	}
+
+	[StructLayout(LayoutKind.Sequential)]
+	struct NativeStatCounters
+	{
+		public long BlocksTransferred;
+		public long CompletedAsync;
+		public long CompletedSync;
+		public long BytesTransferred;
+		public long TrimmedBytes;
+		public long VerifiedBytes;
 
 		public long ReadWriteFilePerfCounts;
 		public long GetQueuedCompletionStatusExPerfCounts;
+		public long ScheduleLagPerfCounts;
+		public long VerifyPerfCounts;
+
+		public long SubmitCalls;
+		public long CompletionCalls;
+
+		public long InFlight;
+
+		public void Add(ref NativeStatCounters other)
+		{
+			BlocksTransferred += other.BlocksTransferred;
+			CompletedAsync += other.CompletedAsync;
+			CompletedSync += other.CompletedSync;
+			BytesTransferred += other.BytesTransferred;
+			TrimmedBytes += other.TrimmedBytes;
+			VerifiedBytes += other.VerifiedBytes;
+			ReadWriteFilePerfCounts += other.ReadWriteFilePerfCounts;
+			GetQueuedCompletionStatusExPerfCounts += other.GetQueuedCompletionStatusExPerfCounts;
+			ScheduleLagPerfCounts += other.ScheduleLagPerfCounts;
+			VerifyPerfCounts += other.VerifyPerfCounts;
+			SubmitCalls += other.SubmitCalls;
+			CompletionCalls += other.CompletionCalls;
+			InFlight += other.InFlight;
+		}
+	}
+
+	// One worker's counters behind a sequence lock. Matches StatBlock in Status.h.
+	[StructLayout(LayoutKind.Sequential)]
+	unsafe struct NativeStatBlock
+	{
+		public const int Size = CacheLine + 8 + 13 * 8;
+		private const int CacheLine = 64;
+
+		private fixed byte Padding[CacheLine];
+		public int Sequence;
+		private int Reserved;
+		public NativeStatCounters Counters;
+	}
+
+	[StructLayout(LayoutKind.Sequential)]
+	unsafe struct NativeLatencyHistogram
+	{
+		public fixed long Buckets[LatencyHistogram.BucketCount];
+	}
+
+	[StructLayout(LayoutKind.Sequential)]
+	struct ReplayRecord
+	{
+		public ulong IssueTime;
+		public ulong Offset;
+		public int Length;
+		public BenchmarkOperation Operation;
+	}
+
+	[StructLayout(LayoutKind.Sequential)]
+	struct NativeOpOptions
+	{
+		public int SubmitBatch;
+		public bool AdaptiveBatch;
+		public bool StrictAsync;
+		public CompletionMode CompletionMode;
+		public int SpinMicroseconds;
+		public int NumaNode;
+		public int CpuGroup;
+		public ulong CpuMask;
+		public int TrimPercent;
+		public TrimType TrimType;
+		public int VerifyThreads;
+		public int Sharers;
+		public int Sharer;
+		public SharedLayout SharedLayout;
+		public bool LockRanges;
+		public bool Append;
+		public long RateBytesPerSec;
+		public bool ScatterGather;
+		public SegmentLayout SegmentLayout;
+		public int Streams;
+		public StreamOrder StreamOrder;
+		public int StreamStride;
+		public bool StreamReverse;
+		public NativeEmulatedDevice Device;
+	}
+
+	[StructLayout(LayoutKind.Sequential)]
+	struct NativeLatencyModel
+	{
+		public LatencyModelType Type;
+		public int MeanMicroseconds;
+		public int DeviationMicroseconds;
+		public int StallsPerMillion;
+		public int StallMicroseconds;
+	}
+
+	[StructLayout(LayoutKind.Sequential)]
+	struct NativeEmulatedDevice
+	{
+		public DeviceType Type;
+		public int Parallelism;
+		public long Capacity;
+		public NativeLatencyModel Latency;
+	}
+
+	[StructLayout(LayoutKind.Sequential)]
+	struct NativeWalOptions
+	{
+		public long Records;
+		public int Producers;
+		public RecordSizeModel RecordModel;
+		public int RecordBytes;
+		public int MinRecordBytes;
+		public int MaxRecordBytes;
+		public int MaxGroupBytes;
+		public int CommitMicroseconds;
+		public bool Flush;
+	}
+
+	[StructLayout(LayoutKind.Sequential)]
+	struct NativeWalResult
+	{
+		public long Commits;
+		public long Records;
+		public long RecordBytes;
+		public long PaddingBytes;
+	}
+
+	[StructLayout(LayoutKind.Sequential, CharSet = CharSet.Unicode)]
+	struct NativeDeviceInfo
+	{
+		public long SizeBytes;
+		public int LogicalSectorBytes;
+		public int PhysicalSectorBytes;
+		public int AlignmentOffsetBytes;
+		public int MaxTransferBytes;
+		public StorageBusType BusType;
+		public bool CommandQueueing;
+		public bool Removable;
+		public bool SeekPenaltyKnown;
+		public bool SeekPenalty;
+		public int Partitions;
+		[MarshalAs(UnmanagedType.ByValTStr, SizeConst = 64)]
+		public string Model;
+		[MarshalAs(UnmanagedType.ByValTStr, SizeConst = 64)]
+		public string SerialNumber;
+	}
+
+	[StructLayout(LayoutKind.Sequential)]
+	struct NativeCpuUsage
+	{
+		public long UserTime;
+		public long KernelTime;
+		public long Cycles;
+	}
+
+	struct CpuSample
+	{
+		public NativeCpuUsage Usage;
+		public long ContextSwitches;
 	}
 }
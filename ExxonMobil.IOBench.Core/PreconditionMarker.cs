@@ -0,0 +1,111 @@
+﻿// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text;
+using ExxonMobil.Shared.Win32;
+
+namespace ExxonMobil.IOBench.Core
+{
+	// Records that a file has been preconditioned in an alternate data stream of the file 
+	// itself, so the record goes wherever the file goes and is gone once the file is deleted. 
+	// File systems without streams simply never hold a marker.
+	public class PreconditionMarker
+	{
+		public long SizeBytes { get; set; }
+		public int SequentialPasses { get; set; }
+		public int RandomRounds { get; set; }
+		public bool Steady { get; set; }
+		public DateTime Time { get; set; }
+
+		// Whether a target conditioned this way needs no further conditioning for the given 
+		// configuration.
+		public bool Covers(BenchmarkConfiguration config)
+		{
+			if (SizeBytes < config.FileSizeBytes || SequentialPasses < config.PreconditionPasses)
+				return false;
+			return config.PreconditionRounds == 0 || Steady || RandomRounds >= config.PreconditionRounds;
+		}
+
+		public static PreconditionMarker Read(string path)
+		{
+			using (var fileHandle = Win32Methods.CreateFile(path + StreamName, Win32FileAccess.GenericRead, Win32FileShare.Read, 
+				IntPtr.Zero, Win32FileCreationDisposition.OpenExisting, Win32FileAttributes.Normal, IntPtr.Zero))
+			{
+				if (fileHandle.IsInvalid)
+					return null;
+
+				var values = new Dictionary<string, string>();
+				Func<string, string> value = key => values.ContainsKey(key) ? values[key] : null;
+				using (var reader = new StreamReader(new FileStream(fileHandle, FileAccess.Read)))
+				{
+					string line;
+					while ((line = reader.ReadLine()) != null)
+					{
+						var separator = line.IndexOf('=');
+						if (separator > 0)
+							values[line.Substring(0, separator)] = line.Substring(separator + 1);
+					}
+				}
+
+				var marker = new PreconditionMarker();
+				long size;
+				int passes, rounds;
+				bool steady;
+				DateTime time;
+				if (value("Version") != Version ||
+					!long.TryParse(value("Size"), out size) ||
+					!int.TryParse(value("Passes"), out passes) ||
+					!int.TryParse(value("Rounds"), out rounds) ||
+					!bool.TryParse(value("Steady"), out steady) ||
+					!DateTime.TryParse(value("Time"), CultureInfo.InvariantCulture, DateTimeStyles.RoundtripKind, out time))
+					return null;
+				marker.SizeBytes = size;
+				marker.SequentialPasses = passes;
+				marker.RandomRounds = rounds;
+				marker.Steady = steady;
+				marker.Time = time;
+				return marker;
+			}
+		}
+
+		// Returns false if the file system has no alternate data streams.
+		public bool Write(string path)
+		{
+			using (var fileHandle = Win32Methods.CreateFile(path + StreamName, Win32FileAccess.GenericWrite, Win32FileShare.None, 
+				IntPtr.Zero, Win32FileCreationDisposition.CreateAlways, Win32FileAttributes.Normal, IntPtr.Zero))
+			{
+				if (fileHandle.IsInvalid)
+					return false;
+
+				using (var writer = new StreamWriter(new FileStream(fileHandle, FileAccess.Write)))
+				{
+					writer.WriteLine("Version=" + Version);
+					writer.WriteLine("Size=" + SizeBytes);
+					writer.WriteLine("Passes=" + SequentialPasses);
+					writer.WriteLine("Rounds=" + RandomRounds);
+					writer.WriteLine("Steady=" + Steady);
+					writer.WriteLine("Time=" + Time.ToString("o", CultureInfo.InvariantCulture));
+				}
+				return true;
+			}
+		}
+
+		private const string StreamName = ":iobench.precondition";
+		private const string Version = "1";
+	}
+}
@@ -0,0 +1,97 @@
+﻿// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.ComponentModel;
+
+namespace ExxonMobil.IOBench.Core
+{
+	// A raw disk named by a device path such as \\.\PhysicalDrive1, as the storage stack 
+	// describes it. Only the size, sector sizes and partition count are always known.
+	public class RawDevice
+	{
+		public string Path { get; private set; }
+		public long SizeBytes { get; private set; }
+		public int LogicalSectorBytes { get; private set; }
+		public int PhysicalSectorBytes { get; private set; }
+		public int AlignmentOffsetBytes { get; private set; }
+		public int MaxTransferBytes { get; private set; }
+		public StorageBusType BusType { get; private set; }
+		public bool CommandQueueing { get; private set; }
+		public bool Removable { get; private set; }
+		public bool? Rotational { get; private set; }
+		public int Partitions { get; private set; }
+		public string Model { get; private set; }
+		public string SerialNumber { get; private set; }
+
+		public static bool IsDevicePath(string path)
+		{
+			return path != null && path.StartsWith(DevicePrefix, StringComparison.Ordinal);
+		}
+
+		public static RawDevice Query(string path)
+		{
+			NativeDeviceInfo info;
+			if (!NativeCore.GetDeviceInfo(path, out info))
+			{
+				var win32ex = new Win32Exception();
+				throw new BenchmarkException("Failed to query the device '" + path + "': " + win32ex.Message, win32ex)
+				{
+					HelpText = "Raw devices are disks named like \\\\.\\PhysicalDrive1, and opening one requires an elevated prompt."
+				};
+			}
+
+			return new RawDevice
+			{
+				Path = path,
+				SizeBytes = info.SizeBytes,
+				LogicalSectorBytes = info.LogicalSectorBytes,
+				PhysicalSectorBytes = info.PhysicalSectorBytes,
+				AlignmentOffsetBytes = info.AlignmentOffsetBytes,
+				MaxTransferBytes = info.MaxTransferBytes,
+				BusType = info.BusType,
+				CommandQueueing = info.CommandQueueing,
+				Removable = info.Removable,
+				Rotational = info.SeekPenaltyKnown ? info.SeekPenalty : (bool?)null,
+				Partitions = info.Partitions,
+				Model = info.Model,
+				SerialNumber = info.SerialNumber
+			};
+		}
+
+		private const string DevicePrefix = @"\\.\";
+	}
+
+	// STORAGE_BUS_TYPE
+	public enum StorageBusType : uint
+	{
+		Unknown           = 0,
+		Scsi              = 1,
+		Atapi             = 2,
+		Ata               = 3,
+		Ieee1394          = 4,
+		Ssa               = 5,
+		Fibre             = 6,
+		Usb               = 7,
+		Raid              = 8,
+		iScsi             = 9,
+		Sas               = 10,
+		Sata              = 11,
+		Sd                = 12,
+		Mmc               = 13,
+		Virtual           = 14,
+		FileBackedVirtual = 15,
+		Spaces            = 16,
+		Nvme              = 17
+	}
+}
@@ -0,0 +1,91 @@
+﻿// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace ExxonMobil.IOBench.Core
+{
+	// Mean and spread of a measurement repeated over several runs. The Student t interval and 
+	// Welch's test tell a real change apart from run-to-run noise.
+	public class SampleStatistics
+	{
+		public SampleStatistics(IEnumerable<double> samples)
+		{
+			var values = samples.ToList();
+			Count = values.Count;
+			if (Count == 0)
+				return;
+			Mean = values.Average();
+			if (Count > 1)
+				StdDev = Math.Sqrt(values.Sum(v => (v - Mean) * (v - Mean)) / (Count - 1));
+		}
+
+		public int Count { get; private set; }
+		public double Mean { get; private set; }
+		public double StdDev { get; private set; }
+
+		private double Variance
+		{
+			get { return StdDev * StdDev / Count; }
+		}
+
+		// Half the width of the 95% confidence interval of the mean, 0 with fewer than two samples.
+		public double ConfidenceHalfWidth95
+		{
+			get { return Count < 2 ? 0 : TCritical95(Count - 1) * StdDev / Math.Sqrt(Count); }
+		}
+
+		// Whether the means of two sets of samples differ at 95% confidence by Welch's t-test, 
+		// which does not assume the two have the same variance.
+		public static bool DiffersSignificantly(SampleStatistics a, SampleStatistics b)
+		{
+			if (a.Count < 2 || b.Count < 2)
+				return false;
+
+			double variance = a.Variance + b.Variance;
+			if (variance == 0)
+				return a.Mean != b.Mean;
+
+			double t = Math.Abs(a.Mean - b.Mean) / Math.Sqrt(variance);
+			double df = variance * variance / 
+				(a.Variance * a.Variance / (a.Count - 1) + b.Variance * b.Variance / (b.Count - 1));
+			return t > TCritical95(df);
+		}
+
+		// Two-sided 95% critical value of Student's t. Fractional degrees of freedom are rounded 
+		// down, which only widens the interval. Past the table the Cornish-Fisher expansion 
+		// around the normal quantile is accurate to three decimals.
+		public static double TCritical95(double df)
+		{
+			int whole = (int)Math.Floor(df);
+			if (whole < 1)
+				whole = 1;
+			if (whole <= TTable95.Length)
+				return TTable95[whole - 1];
+
+			const double z = 1.959964;
+			double z3 = z * z * z;
+			double z5 = z3 * z * z;
+			return z + (z3 + z) / (4 * whole) + (5 * z5 + 16 * z3 + 3 * z) / (96.0 * whole * whole);
+		}
+
+		private static readonly double[] TTable95 =
+		{
+			12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+			 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+			 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+		};
+	}
+}
@@ -0,0 +1,246 @@
+﻿// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Text.RegularExpressions;
+
+namespace ExxonMobil.IOBench.Core
+{
+	// An I/O trace to replay. Two text formats are understood:
+	//
+	//  iobench:  <issue time us> <R|W> <offset bytes> <length bytes> [latency us]
+	//            One request per line. Lines starting with # are ignored.
+	//  blkparse: Default blkparse output. Requests are taken from D (issue) events,
+	//            or Q events if the trace has no D events. Recorded latency is the
+	//            time from issue to the matching C event.
+	public class TraceFile
+	{
+		private TraceFile()
+		{
+		}
+
+		public static TraceFile Load(string path)
+		{
+			if (!File.Exists(path))
+				throw new BenchmarkException("Trace file '" + path + "' not found.");
+
+			var lines = File.ReadAllLines(path);
+			var trace = new TraceFile();
+			var firstLine = lines.Select(l => l.Trim()).FirstOrDefault(l => l.Length > 0 && !l.StartsWith("#"));
+			if (firstLine != null && blkparseLine.IsMatch(firstLine))
+				trace.LoadBlkparse(lines);
+			else
+				trace.LoadIOBench(lines);
+
+			if (trace.records.Length == 0)
+				throw new BenchmarkException("Trace file '" + path + "' has no read or write requests.")
+				{
+					HelpText = "The trace must be in iobench format (<time us> <R|W> <offset> <length> [latency us]) " +
+						"or the default text output of blkparse."
+				};
+
+			return trace;
+		}
+
+		public TraceFormat Format { get; private set; }
+
+		public int Count
+		{
+			get { return records.Length; }
+		}
+
+		public int MaxLength
+		{
+			get { return records.Max(r => r.Length); }
+		}
+
+		public long Extent
+		{
+			get { return records.Max(r => (long)r.Offset + r.Length); }
+		}
+
+		public long TotalBytes
+		{
+			get { return records.Sum(r => (long)r.Length); }
+		}
+
+		public bool HasWrites
+		{
+			get { return records.Any(r => r.Operation == BenchmarkOperation.Write); }
+		}
+
+		public TimeSpan Duration
+		{
+			get { return TimeSpan.FromTicks((long)records[records.Length - 1].IssueTime * 10); }
+		}
+
+		// Null if the trace did not record latencies.
+		public LatencyHistogram RecordedLatency { get; private set; }
+
+		internal ReplayRecord[] Records
+		{
+			get { return records; }
+		}
+
+		private void LoadIOBench(string[] lines)
+		{
+			Format = TraceFormat.IOBench;
+			var list = new List<ReplayRecord>(lines.Length);
+			var latency = new LatencyHistogram();
+
+			for (int i = 0; i < lines.Length; i++)
+			{
+				var line = lines[i].Trim();
+				if (line.Length == 0 || line.StartsWith("#"))
+					continue;
+
+				var fields = line.Split((char[])null, StringSplitOptions.RemoveEmptyEntries);
+				ulong issueTime, offset;
+				int length;
+				long recordedLatency = 0;
+				if (fields.Length < 4 || fields.Length > 5 ||
+					!ulong.TryParse(fields[0], out issueTime) ||
+					!ulong.TryParse(fields[2], out offset) ||
+					!int.TryParse(fields[3], out length) || length <= 0 ||
+					(fields.Length == 5 && !long.TryParse(fields[4], out recordedLatency)))
+					throw InvalidLine(i, "expected <time us> <R|W> <offset> <length> [latency us]");
+
+				BenchmarkOperation op;
+				if (String.Equals(fields[1], "R", StringComparison.OrdinalIgnoreCase))
+					op = BenchmarkOperation.Read;
+				else if (String.Equals(fields[1], "W", StringComparison.OrdinalIgnoreCase))
+					op = BenchmarkOperation.Write;
+				else
+					throw InvalidLine(i, "operation must be R or W");
+
+				if (length % SectorSize != 0)
+					throw InvalidLine(i, "length must be a multiple of " + SectorSize + " bytes");
+				if (offset % SectorSize != 0)
+					throw InvalidLine(i, "offset must be a multiple of " + SectorSize + " bytes");
+
+				list.Add(new ReplayRecord { IssueTime = issueTime, Offset = offset, Length = length, Operation = op });
+				if (fields.Length == 5)
+					latency.Record(recordedLatency);
+			}
+
+			SetRecords(list);
+			if (latency.Count > 0)
+				RecordedLatency = latency;
+		}
+
+		private void LoadBlkparse(string[] lines)
+		{
+			Format = TraceFormat.Blkparse;
+			var events = new List<BlkEvent>(lines.Length);
+			foreach (var line in lines)
+			{
+				var match = blkparseLine.Match(line.Trim());
+				if (!match.Success)
+					continue; // blkparse summaries and unsupported actions
+
+				var rwbs = match.Groups["rwbs"].Value;
+				events.Add(new BlkEvent
+				{
+					Time = decimal.Parse(match.Groups["time"].Value, CultureInfo.InvariantCulture),
+					Action = match.Groups["action"].Value,
+					IsWrite = rwbs.Contains('W'),
+					IsRead = rwbs.Contains('R'),
+					Sector = ulong.Parse(match.Groups["sector"].Value),
+					Sectors = int.Parse(match.Groups["sectors"].Value)
+				});
+			}
+
+			string issueAction = events.Any(e => e.Action == "D") ? "D" : "Q";
+			var list = new List<ReplayRecord>();
+			var latency = new LatencyHistogram();
+			var pending = new Dictionary<Tuple<ulong, int>, Queue<decimal>>();
+
+			foreach (var e in events)
+			{
+				if (e.Sectors == 0 || e.IsRead == e.IsWrite)
+					continue;
+
+				var key = Tuple.Create(e.Sector, e.Sectors);
+				if (e.Action == issueAction)
+				{
+					list.Add(new ReplayRecord
+					{
+						IssueTime = (ulong)(e.Time * 1000000),
+						Offset = e.Sector * SectorSize,
+						Length = e.Sectors * SectorSize,
+						Operation = e.IsWrite ? BenchmarkOperation.Write : BenchmarkOperation.Read
+					});
+
+					Queue<decimal> issued;
+					if (!pending.TryGetValue(key, out issued))
+						pending[key] = issued = new Queue<decimal>();
+					issued.Enqueue(e.Time);
+				}
+				else if (e.Action == "C")
+				{
+					Queue<decimal> issued;
+					if (pending.TryGetValue(key, out issued) && issued.Count > 0)
+						latency.Record((long)((e.Time - issued.Dequeue()) * 1000000));
+				}
+			}
+
+			SetRecords(list);
+			if (latency.Count > 0)
+				RecordedLatency = latency;
+		}
+
+		private void SetRecords(List<ReplayRecord> list)
+		{
+			records = list.OrderBy(r => r.IssueTime).ToArray();
+			if (records.Length == 0)
+				return;
+
+			ulong start = records[0].IssueTime;
+			for (int i = 0; i < records.Length; i++)
+				records[i].IssueTime -= start;
+		}
+
+		private static BenchmarkException InvalidLine(int lineIndex, string reason)
+		{
+			return new BenchmarkException("Invalid trace record on line " + (lineIndex + 1) + ": " + reason + ".");
+		}
+
+		private struct BlkEvent
+		{
+			public decimal Time;
+			public string Action;
+			public bool IsWrite;
+			public bool IsRead;
+			public ulong Sector;
+			public int Sectors;
+		}
+
+		// e.g. "  8,0    3        1     0.000000000   697  D   W 223490 + 8 [kjournald]"
+		private static readonly Regex blkparseLine = new Regex(
+			@"^\d+,\d+\s+\d+\s+\d+\s+(?<time>\d+\.\d+)\s+\d+\s+(?<action>[A-Z])\s+(?<rwbs>[A-Z]+)\s+(?<sector>\d+)\s+\+\s+(?<sectors>\d+)");
+
+		private const int SectorSize = 512;
+		private ReplayRecord[] records;
+	}
+
+	public enum TraceFormat
+	{
+		IOBench,
+		Blkparse
+	}
+}
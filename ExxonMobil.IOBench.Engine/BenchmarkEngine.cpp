@@ -0,0 +1,540 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "BenchmarkEngine.h"
+#include "PerfCount.h"
+#include "Placement.h"
+#include "Trim.h"
+#include "Verifier.h"
+#include "SharedFile.h"
+#include "Pacer.h"
+#include "Segments.h"
+#include "Streams.h"
+#include "DataPattern.h"
+#include "IocpBackend.h"
+#include "SyncBackend.h"
+
+#include <time.h>
+#include <stack>
+
+// A submit call that returns pending after this long blocked on the request itself, as when 
+// NTFS extends a file or the driver queue is full, rather than just handing it to the driver.
+const DWORD BlockedSubmitMicroseconds = 100;
+
+// The loops hand their operation straight to the backends.
+C_ASSERT(IOREQ_WRITE == BENCHOP_WRITE && IOREQ_READ == BENCHOP_READ && IOREQ_TRIM == BENCHOP_TRIM);
+
+// A NULL status is replaced by one the engine owns, zeroed as the managed side zeroes the 
+// one it passes.
+BenchmarkEngine::BenchmarkEngine(const WorkloadSpec& spec, Status* status) :
+	m_spec(spec),
+	m_pStatus(status),
+	m_pBackend(NULL),
+	m_pfnProgress(NULL),
+	m_pvProgressContext(NULL),
+	m_nextProgressBlock(0)
+{
+	if (m_pStatus == NULL)
+	{
+		m_cefOwnStatus = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(Status));
+		m_pStatus = m_cefOwnStatus;
+	}
+	m_liStart.QuadPart = 0;
+	m_liFrequency.QuadPart = 1;
+}
+
+void BenchmarkEngine::SetBackend(IoBackend* backend)
+{
+	m_pBackend = backend;
+}
+
+void BenchmarkEngine::SetProgressRoutine(PENGINE_PROGRESS_ROUTINE routine, PVOID context)
+{
+	m_pfnProgress = routine;
+	m_pvProgressContext = context;
+}
+
+BOOL BenchmarkEngine::Run(HANDLE hFile)
+{
+	if (m_pStatus == NULL)
+	{
+		SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+		return FALSE;
+	}
+	if (!ValidateSpec())
+	{
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	// The loop's counters carry on from what its StatBlock already holds.
+	QueryPerformanceFrequency(&m_liFrequency);
+	QueryPerformanceCounter(&m_liStart);
+	m_nextProgressBlock = m_pStatus->Workers[GetStatWorker(&m_spec.Options)].Counters.BlocksTransferred + m_spec.ProgressBlocks;
+	return m_spec.Synchronous ? RunSynchronous(hFile) : RunAsynchronous(hFile);
+}
+
+// Safe to call from any thread. The loop stops at its next check and Run returns TRUE with 
+// whatever was transferred up to then.
+void BenchmarkEngine::Cancel()
+{
+	if (m_pStatus != NULL)
+		*(volatile BOOL*)&m_pStatus->Canceled = TRUE;
+}
+
+const Status* BenchmarkEngine::Metrics() const
+{
+	return m_pStatus;
+}
+
+// Only what would fault or hang the loops is checked here. The managed side validates the 
+// rest of a configuration before it gets this far.
+BOOL BenchmarkEngine::ValidateSpec() const
+{
+	if (m_spec.Operation != BENCHOP_WRITE && m_spec.Operation != BENCHOP_READ && m_spec.Operation != BENCHOP_TRIM)
+		return FALSE;
+	if (m_spec.AccessPattern != BENCHAP_SEQUENTIAL && m_spec.AccessPattern != BENCHAP_RANDOM)
+		return FALSE;
+	if (m_spec.BlockSize == 0 || (!m_spec.Synchronous && m_spec.QueueDepth == 0))
+		return FALSE;
+	if (m_spec.AccessPattern == BENCHAP_RANDOM && (m_spec.Blocks < 4 || m_spec.Blocks >= (1ULL << 37)))
+		return FALSE;
+	return TRUE;
+}
+
+BOOL BenchmarkEngine::RunAsynchronous(HANDLE hFile)
+{
+	DWORD op = m_spec.Operation;
+	DWORD ap = m_spec.AccessPattern;
+	BOOL verify = m_spec.Verify;
+	ULONGLONG blocks = m_spec.Blocks;
+	DWORD blockSize = m_spec.BlockSize;
+	BOOL randomData = m_spec.RandomData;
+	DWORD maxOutstanding = m_spec.QueueDepth;
+	const OpOptions* options = &m_spec.Options;
+	Status* status = m_pStatus;
+
+	LARGE_INTEGER liCurrentFileOffset = { 0 };
+	DWORD nTransfersInProgress = 0;
+	ULONGLONG currentBlock = 0;
+	DWORD reapedAverage8 = 8; // Moving average of completions per wait in 1/8ths
+	DWORD trimCredit = 0;
+	LARGE_INTEGER liPerfCount;
+	LARGE_INTEGER liFrequency;
+	std::stack<DWORD> reqIdxStack;
+	std::stack<DWORD> freeBuffers;
+	CStatWriter stats(status, GetStatWorker(options));
+
+	// Buffers held by the verifier threads can not be reused until they are checked. Spare 
+	// buffers keep every request slot busy while verification catches up.
+	BOOL verifyOffLoop = op == BENCHOP_READ && verify && options->VerifyThreads;
+	DWORD bufferCount = verifyOffLoop ? maxOutstanding * 2 : maxOutstanding;
+
+	CEnsureHeapFree<IoRequest*> cefRequests = 
+		HeapAlloc(GetProcessHeap(), 0, sizeof(IoRequest) * maxOutstanding);
+	CEnsureHeapFree<IoRequest**> cefCompleted = 
+		HeapAlloc(GetProcessHeap(), 0, sizeof(IoRequest*) * maxOutstanding);
+	CEnsureHeapFree<PDWORD> cefBatch = 
+		HeapAlloc(GetProcessHeap(), 0, sizeof(DWORD) * maxOutstanding);
+	CEnsureHeapFree<PDWORD> cefReqBuffers = 
+		HeapAlloc(GetProcessHeap(), 0, sizeof(DWORD) * maxOutstanding);
+	CEnsureHeapFree<PDWORD> cefReqStreams = 
+		HeapAlloc(GetProcessHeap(), 0, sizeof(DWORD) * maxOutstanding);
+	CThreadPlacement placement;
+	if (!placement.Apply(options))
+		return FALSE;
+	SIZE_T regionSize = options->ScatterGather 
+		? CSegmentMap::RegionSize(bufferCount, blockSize, options->SegmentLayout) 
+		: (SIZE_T)blockSize * bufferCount;
+	CEnsureReleaseRegion erpBuffer = AllocateBuffer(regionSize, options);
+	if ((PVOID)erpBuffer == NULL)
+		return FALSE;
+	CSegmentMap segmentMap;
+	if (options->ScatterGather && !segmentMap.Initialize(erpBuffer, bufferCount, blockSize, options->SegmentLayout))
+		return FALSE;
+	CVerifierPool verifiers;
+	if (verifyOffLoop && !verifiers.Start(options->VerifyThreads, erpBuffer, bufferCount, blockSize, status))
+		return FALSE;
+	CRangeLock rangeLock;
+	if (options->LockRanges && !rangeLock.Initialize())
+		return FALSE;
+	CRatePacer pacer(options);
+	CStreamCursors streams;
+	if (!streams.Initialize(options, blocks, status))
+		return FALSE;
+
+	CIocpBackend iocp(options, status);
+	CEmulatedBackend emulated(options->Device);
+	IoBackend* backend = OpenBackend(hFile, maxOutstanding, &iocp, &emulated);
+	if (backend == NULL)
+		return FALSE;
+	CRequestDrain drain(backend, cefCompleted, maxOutstanding, nTransfersInProgress);
+
+	QueryPerformanceFrequency(&liFrequency);
+	ULONGLONG blockedSubmitCounts = (ULONGLONG)BlockedSubmitMicroseconds * liFrequency.QuadPart / 1000000;
+
+	FiboLfsr lfsr;
+	if (ap == BENCHAP_RANDOM)
+		lfsr = SeedRandom(blocks);
+	CDataPattern pattern;
+	if (randomData)
+		pattern.Seed(m_spec.Seed != 0 ? m_spec.Seed : (ULONGLONG)time(NULL));
+
+	for (DWORD i = 0; i < maxOutstanding; ++i)
+		reqIdxStack.push(i);
+	for (DWORD i = 0; i < bufferCount; ++i)
+		freeBuffers.push(i);
+
+	while ((currentBlock < blocks || nTransfersInProgress) && !status->Canceled)
+	{
+		if (verifiers.Failed())
+		{
+			SetLastError(ERROR_CRC);
+			return FALSE;
+		}
+
+		// Requests are submitted in batches. Each batch is prepared up front and then issued 
+		// back to back once enough slots are free. Adaptive batching sizes the batch to the 
+		// number of completions typically reaped per wait.
+		DWORD batch = options->AdaptiveBatch ? (reapedAverage8 + 4) / 8 : options->SubmitBatch;
+		if (batch == 0)
+			batch = 1;
+		if (batch > maxOutstanding)
+			batch = maxOutstanding;
+
+		while (currentBlock < blocks)
+		{
+			DWORD batchSize = blocks - currentBlock < batch ? (DWORD)(blocks - currentBlock) : batch;
+			if (maxOutstanding - nTransfersInProgress < batchSize)
+				break;
+			if (freeBuffers.size() < batchSize)
+			{
+				verifiers.Reclaim(freeBuffers);
+				if (freeBuffers.size() < batchSize)
+				{
+					// Every spare buffer is waiting on verification. Reap completions if any 
+					// are due, otherwise wait for a verifier to hand a buffer back.
+					if (nTransfersInProgress)
+						break;
+					verifiers.WaitForFreeBuffer();
+					continue;
+				}
+			}
+
+			// A paced loop that is ahead of its rate reaps completions while it has any in 
+			// flight, and otherwise sleeps until the batch is due.
+			if (pacer.MicrosecondsUntilDue() != 0)
+			{
+				if (nTransfersInProgress)
+					break;
+				pacer.WaitUntilDue(status);
+				if (status->Canceled)
+					break;
+			}
+			pacer.Issued((ULONGLONG)batchSize * blockSize);
+
+			// Make new requests
+			for (DWORD i = 0; i < batchSize; ++i)
+			{
+				DWORD currentReqIdx = reqIdxStack.top(); 
+				reqIdxStack.pop();
+				IoRequest* currentReq = cefRequests + currentReqIdx;
+				cefReqBuffers[currentReqIdx] = freeBuffers.top();
+				freeBuffers.pop();
+				LARGE_INTEGER liFileOffset;
+				if (streams.IsEnabled())
+					cefReqStreams[currentReqIdx] = streams.Next(blockSize, &liFileOffset);
+				else
+					MapSharedOffset(options, blocks, blockSize, &liCurrentFileOffset, &liFileOffset);
+				currentReq->Operation = IsTrimRequest(op, options, &trimCredit) ? IOREQ_TRIM : op;
+				currentReq->Buffer = (PBYTE)erpBuffer + ((SIZE_T)cefReqBuffers[currentReqIdx] * blockSize);
+				currentReq->Segments = options->ScatterGather ? segmentMap.Segments(cefReqBuffers[currentReqIdx]) : NULL;
+				currentReq->Length = blockSize;
+				if (currentReq->Operation == IOREQ_WRITE)
+				{
+					if (options->ScatterGather)
+						segmentMap.Fill(cefReqBuffers[currentReqIdx], &liFileOffset, pattern, randomData);
+					else
+						pattern.Fill(currentReq->Buffer, blockSize, &liFileOffset, randomData);
+				}
+				if (options->Append)
+					liFileOffset.QuadPart = -1; // Offset and OffsetHigh of 0xFFFFFFFF write at end of file
+				currentReq->Offset = liFileOffset;
+				cefBatch[i] = currentReqIdx;
+
+				if (ap == BENCHAP_SEQUENTIAL)
+					liCurrentFileOffset.QuadPart += blockSize;
+				else
+					SetNextRandomOffset(&liCurrentFileOffset, blockSize, lfsr);
+			}
+
+			// Submit the batch
+			for (DWORD i = 0; i < batchSize; ++i)
+			{
+				IoRequest* currentReq = cefRequests + cefBatch[i];
+
+				// Waiting on another sharer's lock is not part of submitting the request.
+				if (options->LockRanges && !rangeLock.Lock(hFile, &currentReq->Offset, blockSize))
+					return FALSE;
+				StartPerfCount(&liPerfCount);
+				currentReq->SubmitTime = liPerfCount;
+				if (!backend->Submit(currentReq))
+					return FALSE;
+				ULONGLONG submitCounts;
+				StopPerfCount(&liPerfCount, &submitCounts);
+				stats->ReadWriteFilePerfCounts += submitCounts;
+				++(stats->SubmitCalls);
+				++nTransfersInProgress;
+				++currentBlock;
+				if (currentReq->Synchronous || (options->StrictAsync && submitCounts > blockedSubmitCounts))
+					++(stats->CompletedSync);
+				else
+					++(stats->CompletedAsync);
+			}
+		}
+
+		// A cancel while waiting on the pacer or a verifier can leave nothing to reap.
+		if (nTransfersInProgress == 0)
+			continue;
+
+		// Process completed requests
+		ULONG entriesRemoved = 0;
+		StartPerfCount(&liPerfCount);
+		if (!backend->Reap(cefCompleted, maxOutstanding, INFINITE, &entriesRemoved, &stats->CompletionCalls))
+			return FALSE;
+		StopAndAccumPerfCount(&liPerfCount, &stats->GetQueuedCompletionStatusExPerfCounts);
+		nTransfersInProgress -= entriesRemoved;
+		LARGE_INTEGER liCompleted;
+		QueryPerformanceCounter(&liCompleted);
+		if (entriesRemoved)
+			reapedAverage8 = reapedAverage8 - reapedAverage8 / 8 + entriesRemoved;
+
+		ULONG trimsRemoved = 0;
+		for (ULONG i = 0; i < entriesRemoved; ++i)
+		{
+			IoRequest* currentReq = cefCompleted[i];
+			DWORD reqIdx = (DWORD)(currentReq - cefRequests);
+			BOOL isTrim = currentReq->Operation == IOREQ_TRIM;
+			if (currentReq->Error != ERROR_SUCCESS || currentReq->BytesTransferred != (isTrim ? 0 : blockSize))
+			{
+				SetLastError(currentReq->Error != ERROR_SUCCESS ? currentReq->Error : ERROR_HANDLE_EOF);
+				return FALSE;
+			}
+			if (options->LockRanges && !rangeLock.Unlock(hFile, &currentReq->Offset, blockSize))
+				return FALSE;
+			DWORD bufferIdx = cefReqBuffers[reqIdx];
+			if (op == BENCHOP_READ && verify)
+			{ 
+				if (verifyOffLoop)
+					verifiers.Submit(bufferIdx, &currentReq->Offset);
+				else if (options->ScatterGather ? !segmentMap.Verify(bufferIdx, &currentReq->Offset) : !CDataPattern::Verify(currentReq->Buffer, blockSize, &currentReq->Offset))
+				{
+					SetLastError(ERROR_CRC);
+					return FALSE;
+				}
+				else
+					freeBuffers.push(bufferIdx);
+			}
+			else
+				freeBuffers.push(bufferIdx);
+			ULONGLONG latency = PerfCountToMicroseconds(liCompleted.QuadPart - currentReq->SubmitTime.QuadPart, liFrequency.QuadPart);
+			if (isTrim)
+			{
+				RecordLoopLatency(&status->TrimLatency, latency, options);
+				++trimsRemoved;
+			}
+			else
+				RecordLoopLatency(&status->Latency, latency, options);
+			if (streams.IsEnabled())
+				streams.Completed(cefReqStreams[reqIdx], blockSize, latency, &liCompleted);
+			reqIdxStack.push(reqIdx);
+		}
+
+		stats->InFlight = nTransfersInProgress;
+		ReportProgress(stats, entriesRemoved, (ULONGLONG)(entriesRemoved - trimsRemoved) * blockSize, (ULONGLONG)trimsRemoved * blockSize);
+	}
+
+	// The transfer is not done until every buffer read has been checked.
+	return verifiers.Finish();
+}
+
+BOOL BenchmarkEngine::RunSynchronous(HANDLE hFile)
+{
+	DWORD op = m_spec.Operation;
+	DWORD ap = m_spec.AccessPattern;
+	BOOL verify = m_spec.Verify;
+	ULONGLONG blocks = m_spec.Blocks;
+	DWORD blockSize = m_spec.BlockSize;
+	BOOL randomData = m_spec.RandomData;
+	const OpOptions* options = &m_spec.Options;
+	Status* status = m_pStatus;
+
+	ULONGLONG currentBlock = 0;
+	DWORD trimCredit = 0;
+	
+	LARGE_INTEGER liCurrentFileOffset = { 0 };
+	LARGE_INTEGER liPerfCount;
+	LARGE_INTEGER liCompleted;
+	LARGE_INTEGER liFrequency;
+	LARGE_INTEGER liFileOffset;
+	IoRequest request;
+	IoRequest* completed;
+	ULONG reaped;
+	CStatWriter stats(status, GetStatWorker(options));
+
+	QueryPerformanceFrequency(&liFrequency);
+	CThreadPlacement placement;
+	if (!placement.Apply(options))
+		return FALSE;
+	SIZE_T regionSize = options->ScatterGather ? CSegmentMap::RegionSize(1, blockSize, options->SegmentLayout) : blockSize;
+	CEnsureReleaseRegion erpBuffer = AllocateBuffer(regionSize, options);
+	if ((PVOID)erpBuffer == NULL)
+		return FALSE;
+	CSegmentMap segmentMap;
+	if (options->ScatterGather && !segmentMap.Initialize(erpBuffer, 1, blockSize, options->SegmentLayout))
+		return FALSE;
+	CRangeLock rangeLock;
+	if (options->LockRanges && !rangeLock.Initialize())
+		return FALSE;
+	CRatePacer pacer(options);
+	CStreamCursors streams;
+	if (!streams.Initialize(options, blocks, status))
+		return FALSE;
+
+	CSyncBackend sync(options);
+	CEmulatedBackend emulated(options->Device);
+	IoBackend* backend = OpenBackend(hFile, 1, &sync, &emulated);
+	if (backend == NULL)
+		return FALSE;
+
+	FiboLfsr lfsr;
+	if (ap == BENCHAP_RANDOM)
+		lfsr = SeedRandom(blocks);
+	CDataPattern pattern;
+	if (randomData)
+		pattern.Seed(m_spec.Seed != 0 ? m_spec.Seed : (ULONGLONG)time(NULL));
+
+	while (currentBlock < blocks && !status->Canceled)
+	{
+		pacer.WaitUntilDue(status);
+		if (status->Canceled)
+			break;
+		pacer.Issued(blockSize);
+		BOOL isTrim = IsTrimRequest(op, options, &trimCredit);
+		DWORD stream = 0;
+		if (streams.IsEnabled())
+			stream = streams.Next(blockSize, &liFileOffset);
+		else
+			MapSharedOffset(options, blocks, blockSize, &liCurrentFileOffset, &liFileOffset);
+		if (op == BENCHOP_WRITE && !isTrim)
+		{
+			if (options->ScatterGather)
+				segmentMap.Fill(0, &liFileOffset, pattern, randomData);
+			else
+				pattern.Fill(erpBuffer, blockSize, &liFileOffset, randomData);
+		}
+		request.Operation = isTrim ? IOREQ_TRIM : op;
+		request.Buffer = erpBuffer;
+		request.Segments = options->ScatterGather ? segmentMap.Segments(0) : NULL;
+		request.Length = blockSize;
+		request.Offset = liFileOffset;
+		if (options->Append)
+			request.Offset.QuadPart = -1; // an append only handle writes at the end of the file
+
+		if (options->LockRanges && !rangeLock.Lock(hFile, &liFileOffset, blockSize))
+			return FALSE;
+		StartPerfCount(&liPerfCount);
+		request.SubmitTime = liPerfCount;
+		if (!backend->Submit(&request) || !backend->Reap(&completed, 1, INFINITE, &reaped, &stats->CompletionCalls))
+			return FALSE;
+		StopAndAccumPerfCount(&liPerfCount, &stats->ReadWriteFilePerfCounts);
+		QueryPerformanceCounter(&liCompleted);
+		++(stats->SubmitCalls);
+		if (request.Error != ERROR_SUCCESS || request.BytesTransferred != (isTrim ? 0 : blockSize))
+		{
+			SetLastError(request.Error != ERROR_SUCCESS ? request.Error : ERROR_HANDLE_EOF);
+			return FALSE;
+		}
+		if (options->LockRanges && !rangeLock.Unlock(hFile, &liFileOffset, blockSize))
+			return FALSE;
+		ULONGLONG latency = PerfCountToMicroseconds(liCompleted.QuadPart - request.SubmitTime.QuadPart, liFrequency.QuadPart);
+		RecordLoopLatency(isTrim ? &status->TrimLatency : &status->Latency, latency, options);
+		if (streams.IsEnabled())
+			streams.Completed(stream, blockSize, latency, &liCompleted);
+
+		BOOL verified = !(op == BENCHOP_READ && verify) || 
+			(options->ScatterGather ? segmentMap.Verify(0, &liFileOffset) : CDataPattern::Verify(erpBuffer, blockSize, &liFileOffset));
+		if (!verified)
+		{
+			SetLastError(ERROR_CRC);
+			return FALSE;
+		}
+
+		if (ap == BENCHAP_SEQUENTIAL)
+			liCurrentFileOffset.QuadPart += blockSize;
+		else
+			SetNextRandomOffset(&liCurrentFileOffset, blockSize, lfsr);
+		++currentBlock;
+
+		++(stats->CompletedSync);
+		ReportProgress(stats, 1, isTrim ? 0 : blockSize, isTrim ? blockSize : 0);
+	}
+
+	return TRUE;
+}
+
+// The backend set on the engine, or else an emulated device in the options, takes the place 
+// of the loop's own file backend. A RAM device about to be read is given the offset pattern 
+// first, so its reads can be verified.
+IoBackend* BenchmarkEngine::OpenBackend(HANDLE hFile, DWORD queueDepth, IoBackend* fileBackend, CEmulatedBackend* emulated)
+{
+	IoBackend* backend = m_pBackend != NULL 
+		? m_pBackend 
+		: m_spec.Options.Device.Type == EMULATED_NONE ? fileBackend : emulated;
+	if (!backend->Open(hFile, queueDepth))
+		return NULL;
+	if (backend == emulated && m_spec.Operation == BENCHOP_READ)
+		emulated->Prefill();
+	return backend;
+}
+
+// Publishes the batch, and once ProgressBlocks more requests have finished since the last 
+// call, hands the progress routine a copy of what was published.
+void BenchmarkEngine::ReportProgress(CStatWriter& stats, ULONGLONG blocks, ULONGLONG bytes, ULONGLONG trimmedBytes)
+{
+	AddProgress(stats, blocks, bytes, trimmedBytes);
+	if (m_pfnProgress == NULL || m_spec.ProgressBlocks == 0 || stats->BlocksTransferred < m_nextProgressBlock)
+		return;
+	m_nextProgressBlock = stats->BlocksTransferred + m_spec.ProgressBlocks;
+
+	EngineMetrics metrics;
+	metrics.Counters = stats.Counters();
+	LARGE_INTEGER liNow;
+	QueryPerformanceCounter(&liNow);
+	metrics.ElapsedMicroseconds = PerfCountToMicroseconds(liNow.QuadPart - m_liStart.QuadPart, m_liFrequency.QuadPart);
+	if (!m_pfnProgress(&metrics, m_pvProgressContext))
+		Cancel();
+}
+
+FiboLfsr BenchmarkEngine::SeedRandom(ULONGLONG blocks)
+{
+	UCHAR bitWidth = 0;
+	while (blocks >>= 1) ++bitWidth;
+	return FiboLfsr(bitWidth);
+}
+
+void BenchmarkEngine::SetNextRandomOffset(PLARGE_INTEGER pliOffset, DWORD blockSize, FiboLfsr& lfsr)
+{
+	ULONGLONG block = lfsr.Next();
+	pliOffset->QuadPart = (LONGLONG)blockSize * block;
+}
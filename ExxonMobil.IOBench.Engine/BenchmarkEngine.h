@@ -0,0 +1,73 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include "WorkloadSpec.h"
+#include "Status.h"
+#include "StatWriter.h"
+#include "IoBackend.h"
+#include "EmulatedBackend.h"
+#include "FiboLfsr.h"
+#include "ResourceHelper.h"
+
+// What the progress routine sees of a running loop.
+struct EngineMetrics
+{
+	StatCounters Counters;          // the loop's counters as just published to its StatBlock
+	ULONGLONG ElapsedMicroseconds;  // since Run started
+};
+
+// Called from the thread running the engine. Return FALSE to cancel the run.
+typedef BOOL (CALLBACK *PENGINE_PROGRESS_ROUTINE)(const EngineMetrics* metrics, PVOID context);
+
+// Runs a WorkloadSpec against one target. Counters and latencies go to the Status passed in, 
+// which the managed side reads while the loop runs, or to one the engine owns when it is 
+// NULL. All other state lives in the instance, so any number of engines can run at once on 
+// their own threads.
+class BenchmarkEngine
+{
+public:
+	BenchmarkEngine(const WorkloadSpec& spec, Status* status);
+
+	// Transfers through backend instead of the one the spec selects. The backend is borrowed 
+	// and must outlive the engine.
+	void SetBackend(IoBackend* backend);
+	void SetProgressRoutine(PENGINE_PROGRESS_ROUTINE routine, PVOID context);
+	BOOL Run(HANDLE hFile);
+	void Cancel();
+	const Status* Metrics() const;
+
+private:
+	BenchmarkEngine(const BenchmarkEngine&);
+	BenchmarkEngine& operator=(const BenchmarkEngine&);
+
+	BOOL ValidateSpec() const;
+	BOOL RunAsynchronous(HANDLE hFile);
+	BOOL RunSynchronous(HANDLE hFile);
+	IoBackend* OpenBackend(HANDLE hFile, DWORD queueDepth, IoBackend* fileBackend, CEmulatedBackend* emulated);
+	void ReportProgress(CStatWriter& stats, ULONGLONG blocks, ULONGLONG bytes, ULONGLONG trimmedBytes);
+	static FiboLfsr SeedRandom(ULONGLONG blocks);
+	static void SetNextRandomOffset(PLARGE_INTEGER pliOffset, DWORD blockSize, FiboLfsr& lfsr);
+
+	WorkloadSpec m_spec;
+	CEnsureHeapFree<Status*> m_cefOwnStatus;
+	Status* m_pStatus;
+	IoBackend* m_pBackend;
+	PENGINE_PROGRESS_ROUTINE m_pfnProgress;
+	PVOID m_pvProgressContext;
+	ULONGLONG m_nextProgressBlock;
+	LARGE_INTEGER m_liStart;
+	LARGE_INTEGER m_liFrequency;
+};
@@ -0,0 +1,28 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "CpuUsage.h"
+
+// Adds the whole lifetime of a thread to usage. Used for helper threads that only run for 
+// the length of a transfer, once they have exited.
+BOOL AddThreadCpuUsage(HANDLE hThread, CpuUsage* usage)
+{
+	FILETIME ftCreation, ftExit, ftKernel, ftUser;
+	ULONG64 cycles;
+	if (!GetThreadTimes(hThread, &ftCreation, &ftExit, &ftKernel, &ftUser) || !QueryThreadCycleTime(hThread, &cycles))
+		return FALSE;
+	usage->UserTime += ((ULONGLONG)ftUser.dwHighDateTime << 32) | ftUser.dwLowDateTime;
+	usage->KernelTime += ((ULONGLONG)ftKernel.dwHighDateTime << 32) | ftKernel.dwLowDateTime;
+	usage->Cycles += cycles;
+	return TRUE;
+}
@@ -0,0 +1,26 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+
+// CPU consumed by a thread. Layout is shared with the managed NativeCpuUsage.
+struct CpuUsage
+{
+	ULONGLONG UserTime;   // 100ns units
+	ULONGLONG KernelTime; // 100ns units
+	ULONGLONG Cycles;
+};
+
+BOOL AddThreadCpuUsage(HANDLE hThread, CpuUsage* usage);
@@ -0,0 +1,62 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "DataPattern.h"
+
+#include <crtdbg.h>
+
+CDataPattern::CDataPattern()
+{
+}
+
+void CDataPattern::Seed(ULONGLONG seed)
+{
+	m_engine = std::tr1::mt19937_64(seed);
+}
+
+void CDataPattern::Fill(PVOID pBuffer, DWORD dwBufferSize, const LARGE_INTEGER* pliOffset, BOOL randomData) 
+{
+	if (!randomData)
+	{
+		Fill(pBuffer, dwBufferSize, pliOffset);
+		return;
+	}
+
+	_ASSERT(dwBufferSize % sizeof(LONGLONG) == 0);
+	PLONGLONG pllBuff = (PLONGLONG)pBuffer;
+	PVOID pEnd = (PBYTE)pBuffer + dwBufferSize;
+	for	(; pllBuff < pEnd; ++pllBuff)
+		*pllBuff = m_engine();
+}
+
+void CDataPattern::Fill(PVOID pBuffer, DWORD dwBufferSize, const LARGE_INTEGER* pliOffset) 
+{
+	_ASSERT(dwBufferSize % sizeof(LONGLONG) == 0);
+	LONGLONG recordIndex = pliOffset->QuadPart / sizeof(LONGLONG);
+	PLONGLONG pllBuff = (PLONGLONG)pBuffer;
+	PVOID pEnd = (PBYTE)pBuffer + dwBufferSize;
+	for	(; pllBuff < pEnd; ++pllBuff, ++recordIndex)
+		*pllBuff = recordIndex;
+}
+
+BOOL CDataPattern::Verify(PVOID pBuffer, DWORD dwBufferSize, const LARGE_INTEGER* pliOffset) 
+{
+	_ASSERT(dwBufferSize % sizeof(LONGLONG) == 0);
+	LONGLONG recordIndex = pliOffset->QuadPart / sizeof(LONGLONG);
+	PLONGLONG pllBuff = (PLONGLONG)pBuffer;
+	PVOID pEnd = (PBYTE)pBuffer + dwBufferSize;
+	for	(; pllBuff < pEnd; ++pllBuff, ++recordIndex)
+		if (*pllBuff != recordIndex) 
+			return FALSE;
+	return TRUE;
+}
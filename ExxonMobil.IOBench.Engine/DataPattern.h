@@ -0,0 +1,34 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include <random>
+
+// Data written and checked by iobench. Each 8 byte record holds its own index in the file,
+// so a block can be verified wherever it is read from. Random data has no pattern and is
+// drawn from a generator owned by the instance, never from shared state.
+class CDataPattern
+{
+public:
+	CDataPattern();
+
+	void Seed(ULONGLONG seed);
+	void Fill(PVOID pBuffer, DWORD dwBufferSize, const LARGE_INTEGER* pliOffset, BOOL randomData);
+	static void Fill(PVOID pBuffer, DWORD dwBufferSize, const LARGE_INTEGER* pliOffset);
+	static BOOL Verify(PVOID pBuffer, DWORD dwBufferSize, const LARGE_INTEGER* pliOffset);
+
+private:
+	std::tr1::mt19937_64 m_engine;
+};
@@ -0,0 +1,199 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "EmulatedBackend.h"
+#include "DataPattern.h"
+
+// Fixed so a model produces the same latency sequence on every run.
+#define LATENCY_SEED 0xBEEF
+
+CEmulatedBackend::CEmulatedBackend(const EmulatedDevice& device) :
+	m_device(device),
+	m_llFrequency(0),
+	m_bCanceled(FALSE),
+	m_engine(LATENCY_SEED),
+	m_normal(device.Latency.MeanMicroseconds, device.Latency.DeviationMicroseconds ? device.Latency.DeviationMicroseconds : 1)
+{
+}
+
+BOOL CEmulatedBackend::Open(HANDLE hFile, DWORD queueDepth)
+{
+	LARGE_INTEGER liFrequency, liNow;
+	QueryPerformanceFrequency(&liFrequency);
+	QueryPerformanceCounter(&liNow);
+	m_llFrequency = liFrequency.QuadPart;
+	m_bCanceled = FALSE;
+	m_pending = std::priority_queue<Pending>();
+	m_channelFree.assign(m_device.Parallelism, liNow.QuadPart);
+
+	if (m_device.Type == EMULATED_RAM && (PVOID)m_erpMemory == NULL)
+	{
+		if (m_device.Capacity == 0 || m_device.Capacity > (SIZE_T)-1)
+		{
+			SetLastError(ERROR_INVALID_PARAMETER);
+			return FALSE;
+		}
+		m_erpMemory = VirtualAlloc(NULL, (SIZE_T)m_device.Capacity, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+		if ((PVOID)m_erpMemory == NULL)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+void CEmulatedBackend::Prefill()
+{
+	if ((PVOID)m_erpMemory == NULL)
+		return;
+
+	// Filled in pieces so the block size never has to fit in a DWORD.
+	const DWORD chunk = 64 * 1024 * 1024;
+	for (ULONGLONG offset = 0; offset < m_device.Capacity; offset += chunk)
+	{
+		LARGE_INTEGER liOffset;
+		liOffset.QuadPart = (LONGLONG)offset;
+		ULONGLONG remaining = m_device.Capacity - offset;
+		CDataPattern::Fill((PBYTE)(PVOID)m_erpMemory + offset, remaining < chunk ? (DWORD)remaining : chunk, &liOffset);
+	}
+}
+
+BOOL CEmulatedBackend::Submit(IoRequest* request)
+{
+	Transfer(request);
+
+	LARGE_INTEGER liNow;
+	QueryPerformanceCounter(&liNow);
+	LONGLONG start = liNow.QuadPart;
+	if (!m_channelFree.empty())
+	{
+		std::vector<LONGLONG>::iterator channel = m_channelFree.begin();
+		for (std::vector<LONGLONG>::iterator it = m_channelFree.begin(); it != m_channelFree.end(); ++it)
+			if (*it < *channel)
+				channel = it;
+		if (*channel > start)
+			start = *channel;
+		*channel = start + SampleLatency();
+		start = *channel;
+	}
+	else
+		start += SampleLatency();
+
+	Pending pending = { start, request };
+	m_pending.push(pending);
+	return TRUE;
+}
+
+BOOL CEmulatedBackend::Reap(IoRequest** requests, ULONG count, DWORD milliseconds, PULONG reaped, PULONGLONG calls)
+{
+	if (m_pending.empty())
+	{
+		SetLastError(ERROR_NO_MORE_ITEMS);
+		return FALSE;
+	}
+
+	LARGE_INTEGER liNow;
+	LONGLONG due = m_pending.top().Due;
+	if (milliseconds != INFINITE)
+	{
+		QueryPerformanceCounter(&liNow);
+		LONGLONG limit = liNow.QuadPart + (LONGLONG)milliseconds * m_llFrequency / 1000;
+		if (limit < due)
+			due = limit;
+	}
+	++*calls;
+	if (!m_bCanceled)
+		WaitUntil(due);
+
+	QueryPerformanceCounter(&liNow);
+	ULONG removed = 0;
+	while (removed < count && !m_pending.empty() && (m_bCanceled || m_pending.top().Due <= liNow.QuadPart))
+	{
+		requests[removed++] = m_pending.top().Request;
+		m_pending.pop();
+	}
+
+	*reaped = removed;
+	return TRUE;
+}
+
+// Held requests are released at once; their data has already moved.
+void CEmulatedBackend::CancelAll()
+{
+	m_bCanceled = TRUE;
+}
+
+void CEmulatedBackend::Transfer(IoRequest* request)
+{
+	request->BytesTransferred = request->Length;
+	request->Error = ERROR_SUCCESS;
+	request->Synchronous = FALSE;
+	if (m_device.Type != EMULATED_RAM)
+		return;
+
+	ULONGLONG offset = (ULONGLONG)request->Offset.QuadPart;
+	if (offset >= m_device.Capacity || m_device.Capacity - offset < request->Length)
+	{
+		request->BytesTransferred = 0;
+		request->Error = ERROR_HANDLE_EOF;
+		return;
+	}
+
+	PBYTE pDevice = (PBYTE)(PVOID)m_erpMemory + offset;
+	if (request->Operation == IOREQ_WRITE)
+		CopyMemory(pDevice, request->Buffer, request->Length);
+	else
+		CopyMemory(request->Buffer, pDevice, request->Length);
+}
+
+// Service time in performance counts.
+LONGLONG CEmulatedBackend::SampleLatency()
+{
+	const LatencyModel& model = m_device.Latency;
+	double microseconds;
+	switch (model.Type)
+	{
+	case LATENCY_FIXED:
+		microseconds = model.MeanMicroseconds;
+		break;
+	case LATENCY_NORMAL:
+	case LATENCY_LONGTAIL:
+		// The distribution needs a positive deviation; zero means every request takes the mean.
+		microseconds = model.DeviationMicroseconds ? m_normal(m_engine) : model.MeanMicroseconds;
+		if (microseconds < 0)
+			microseconds = 0;
+		if (model.Type == LATENCY_LONGTAIL && m_engine() % 1000000 < model.StallsPerMillion)
+			microseconds += model.StallMicroseconds;
+		break;
+	default:
+		return 0;
+	}
+	return (LONGLONG)(microseconds * m_llFrequency / 1000000);
+}
+
+// Sleep is only precise to the scheduler tick, so it covers the bulk of long waits and the 
+// rest is spun.
+void CEmulatedBackend::WaitUntil(LONGLONG due)
+{
+	const LONGLONG tickCounts = m_llFrequency / 50;
+
+	LARGE_INTEGER liNow;
+	QueryPerformanceCounter(&liNow);
+	if (due - liNow.QuadPart > tickCounts)
+		Sleep((DWORD)((due - liNow.QuadPart - tickCounts) * 1000 / m_llFrequency));
+
+	do
+	{
+		YieldProcessor();
+		QueryPerformanceCounter(&liNow);
+	}
+	while (liNow.QuadPart < due);
+}
@@ -0,0 +1,62 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include <queue>
+#include <vector>
+#include <random>
+#include "IoBackend.h"
+#include "EmulatedDevice.h"
+#include "ResourceHelper.h"
+
+// A device emulated on the issuing thread. Data moves when a request is submitted; the 
+// request is then held until its service time has passed. With a parallelism limit, a 
+// request waits for the channel that frees first before its service time starts, the way 
+// requests queue behind a device's internal queues. No threads or timers are involved, so 
+// the latencies a loop records are the modelled ones plus the loop's own overhead.
+class CEmulatedBackend : public IoBackend
+{
+public:
+	CEmulatedBackend(const EmulatedDevice& device);
+
+	BOOL Open(HANDLE hFile, DWORD queueDepth);
+	BOOL Submit(IoRequest* request);
+	BOOL Reap(IoRequest** requests, ULONG count, DWORD milliseconds, PULONG reaped, PULONGLONG calls);
+	void CancelAll();
+
+	// Writes the offset pattern over the whole RAM device so reads can be verified.
+	void Prefill();
+
+private:
+	struct Pending
+	{
+		LONGLONG Due;
+		IoRequest* Request;
+		bool operator<(const Pending& other) const { return Due > other.Due; }
+	};
+
+	void Transfer(IoRequest* request);
+	LONGLONG SampleLatency();
+	void WaitUntil(LONGLONG due);
+
+	EmulatedDevice m_device;
+	CEnsureReleaseRegion m_erpMemory;
+	std::priority_queue<Pending> m_pending;
+	std::vector<LONGLONG> m_channelFree;
+	LONGLONG m_llFrequency;
+	BOOL m_bCanceled;
+	std::tr1::mt19937_64 m_engine;
+	std::tr1::normal_distribution<double> m_normal;
+};
@@ -0,0 +1,44 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+
+#define EMULATED_NONE 0 // the transfer loop's own file
+#define EMULATED_NULL 1
+#define EMULATED_RAM  2
+
+#define LATENCY_NONE     0
+#define LATENCY_FIXED    1
+#define LATENCY_NORMAL   2
+#define LATENCY_LONGTAIL 3
+
+// Service time of an emulated request. Layout is shared with the managed NativeLatencyModel.
+struct LatencyModel
+{
+	DWORD Type;                  // LATENCY_*
+	DWORD MeanMicroseconds;
+	DWORD DeviationMicroseconds; // LATENCY_NORMAL and LATENCY_LONGTAIL
+	DWORD StallsPerMillion;      // LATENCY_LONGTAIL requests per million that stall
+	DWORD StallMicroseconds;     // added to a stalled request
+};
+
+// Layout is shared with the managed NativeEmulatedDevice.
+struct EmulatedDevice
+{
+	DWORD Type;          // EMULATED_*
+	DWORD Parallelism;   // requests serviced at once, 0 for no limit
+	ULONGLONG Capacity;  // bytes of memory behind EMULATED_RAM
+	LatencyModel Latency;
+};
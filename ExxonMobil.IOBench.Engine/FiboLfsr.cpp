@@ -11,13 +11,11 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
-#include "stdafx.h"
-
 #include "FiboLfsr.h"
 
 #include <exception>
 
-const FiboLfsr::Polynomial FiboLfsr::polys[15] = {
+const FiboLfsr::Polynomial FiboLfsr::polys[35] = {
 	{ 2, {0, 1, 2, 2}, false}, // degrees: 2, 1, 0, 0
 	{ 3, {0, 1, 3, 3}, false}, // degrees: 3, 2, 0, 0
 	{ 4, {0, 1, 4, 4}, false}, // degrees: 4, 3, 0, 0
@@ -32,7 +30,27 @@ const FiboLfsr::Polynomial FiboLfsr::polys[15] = {
 	{ 13, {0, 1, 2, 5}, true}, // degrees: 13, 12, 11, 8
 	{ 14, {0, 1, 2, 12}, true}, // degrees: 14, 13, 12, 2
 	{ 15, {0, 1, 15, 15}, false}, // degrees: 15, 14, 0, 0
-	{ 16, {0, 2, 3, 5}, true} // degrees: 16, 14, 13, 11
+	{ 16, {0, 2, 3, 5}, true}, // degrees: 16, 14, 13, 11
+	{ 17, {0, 3, 17, 17}, false}, // degrees: 17, 14, 0, 0
+	{ 18, {0, 7, 18, 18}, false}, // degrees: 18, 11, 0, 0
+	{ 19, {0, 13, 17, 18}, true}, // degrees: 19, 6, 2, 1
+	{ 20, {0, 3, 20, 20}, false}, // degrees: 20, 17, 0, 0
+	{ 21, {0, 2, 21, 21}, false}, // degrees: 21, 19, 0, 0
+	{ 22, {0, 1, 22, 22}, false}, // degrees: 22, 21, 0, 0
+	{ 23, {0, 5, 23, 23}, false}, // degrees: 23, 18, 0, 0
+	{ 24, {0, 1, 2, 7}, true}, // degrees: 24, 23, 22, 17
+	{ 25, {0, 3, 25, 25}, false}, // degrees: 25, 22, 0, 0
+	{ 26, {0, 20, 24, 25}, true}, // degrees: 26, 6, 2, 1
+	{ 27, {0, 22, 25, 26}, true}, // degrees: 27, 5, 2, 1
+	{ 28, {0, 3, 28, 28}, false}, // degrees: 28, 25, 0, 0
+	{ 29, {0, 2, 29, 29}, false}, // degrees: 29, 27, 0, 0
+	{ 30, {0, 24, 26, 29}, true}, // degrees: 30, 6, 4, 1
+	{ 31, {0, 3, 31, 31}, false}, // degrees: 31, 28, 0, 0
+	{ 32, {0, 10, 30, 31}, true}, // degrees: 32, 22, 2, 1
+	{ 33, {0, 13, 33, 33}, false}, // degrees: 33, 20, 0, 0
+	{ 34, {0, 7, 32, 33}, true}, // degrees: 34, 27, 2, 1
+	{ 35, {0, 2, 35, 35}, false}, // degrees: 35, 33, 0, 0
+	{ 36, {0, 11, 36, 36}, false} // degrees: 36, 25, 0, 0
 };
 
 FiboLfsr::FiboLfsr() :
@@ -43,12 +61,12 @@ FiboLfsr::FiboLfsr() :
 FiboLfsr::FiboLfsr(uint8_t width) :
 	complete(false)
 {
-	if (width < 2 || width > 16)
-		throw std::exception("Width out of range (2-16)");
+	if (width < 2 || width > 36)
+		throw std::exception("Width out of range (2-36)");
 
 	poly = polys + (width - 2);
 
-	uint32_t mask = (UINT32_MAX >> (32 - width));
+	uint64_t mask = (UINT64_MAX >> (64 - width));
 	lfsr = seed = 0xBEEF & mask;
 }
 
@@ -56,12 +74,12 @@ FiboLfsr::~FiboLfsr()
 {
 }
 
-uint32_t FiboLfsr::Next()
+uint64_t FiboLfsr::Next()
 {
 	if (complete) 
 		return 0;
 
-	uint32_t bit;
+	uint64_t bit;
 	const uint8_t* shifts = poly->shifts;
 
 	if (poly->doubleTap)
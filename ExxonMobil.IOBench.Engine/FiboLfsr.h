@@ -22,7 +22,7 @@ public:
 	FiboLfsr(uint8_t width);
 	~FiboLfsr();
 
-	uint32_t Next();
+	uint64_t Next();
 
 private:
 	struct Polynomial {
@@ -31,11 +31,11 @@ private:
 		bool doubleTap; // zombieland rule #2
 	};
 
-	static const Polynomial polys[15];
+	static const Polynomial polys[35];
 
 	const Polynomial* poly;
-	uint32_t lfsr;
-	uint32_t seed;
+	uint64_t lfsr;
+	uint64_t seed;
 	bool complete;
 };
 
@@ -0,0 +1,35 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "IoBackend.h"
+
+CRequestDrain::CRequestDrain(IoBackend* backend, IoRequest** completed, ULONG count, const DWORD& inFlight) :
+	m_pBackend(backend),
+	m_ppCompleted(completed),
+	m_ulCount(count),
+	m_inFlight(inFlight)
+{
+}
+
+CRequestDrain::~CRequestDrain()
+{
+	if (m_inFlight == 0)
+		return;
+
+	m_pBackend->CancelAll();
+	DWORD inFlight = m_inFlight;
+	ULONG reaped;
+	ULONGLONG calls = 0;
+	while (inFlight && m_pBackend->Reap(m_ppCompleted, m_ulCount, INFINITE, &reaped, &calls))
+		inFlight -= reaped;
+}
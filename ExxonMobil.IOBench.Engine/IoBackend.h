@@ -0,0 +1,75 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+
+// Values match BENCHOP_* in OpOptions.h.
+#define IOREQ_WRITE 1
+#define IOREQ_READ  2
+#define IOREQ_TRIM  3
+
+// One transfer owned by a loop. The OVERLAPPED must stay first so backends can map a
+// completion straight back to its request.
+struct IoRequest
+{
+	OVERLAPPED Overlapped;
+	DWORD Operation;                 // IOREQ_*
+	PVOID Buffer;
+	FILE_SEGMENT_ELEMENT* Segments;  // page list transferred instead of Buffer, or NULL
+	DWORD Length;
+	LARGE_INTEGER Offset;            // -1 writes at the end of the file
+	DWORD BytesTransferred;
+	DWORD Error;
+	BOOL Synchronous;                // the submit call finished the request itself
+	LARGE_INTEGER SubmitTime;
+};
+
+// How a transfer loop moves data. Backends hold no state outside the instance, so one
+// backend per loop lets any number of loops run side by side.
+class IoBackend
+{
+public:
+	virtual ~IoBackend() {}
+
+	// Binds the backend to the target before the first request.
+	virtual BOOL Open(HANDLE hFile, DWORD queueDepth) = 0;
+	// Starts a request. FALSE means it was never started; a started request that fails 
+	// reports its error through Reap.
+	virtual BOOL Submit(IoRequest* request) = 0;
+	// Waits up to milliseconds, or INFINITE, for at least one started request to finish and 
+	// returns up to count of them. None are returned if the time runs out first, or if the 
+	// backend gives up waiting because the run was canceled. calls counts the waits made, one 
+	// per system call where the backend makes them.
+	virtual BOOL Reap(IoRequest** requests, ULONG count, DWORD milliseconds, PULONG reaped, PULONGLONG calls) = 0;
+	// Asks the target to abandon started requests. They are still returned by Reap, which 
+	// from then on waits for them whether or not the run was canceled.
+	virtual void CancelAll() = 0;
+};
+
+// A request's buffer and OVERLAPPED belong to the target until it completes. A loop that 
+// leaves early, on an error or a cancel, has this cancel and reap whatever it still has in 
+// flight before its buffers are released; declare it after them.
+class CRequestDrain
+{
+public:
+	CRequestDrain(IoBackend* backend, IoRequest** completed, ULONG count, const DWORD& inFlight);
+	~CRequestDrain();
+
+private:
+	IoBackend* m_pBackend;
+	IoRequest** m_ppCompleted;
+	ULONG m_ulCount;
+	const DWORD& m_inFlight;
+};
@@ -0,0 +1,171 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "OpOptions.h"
+#include "Status.h"
+#include "Trim.h"
+#include "Segments.h"
+#include "IocpBackend.h"
+
+CIocpBackend::CIocpBackend(const OpOptions* options, const Status* status) :
+	m_pOptions(options),
+	m_pStatus(status),
+	m_hFile(INVALID_HANDLE_VALUE),
+	m_ulEntries(0)
+{
+	LARGE_INTEGER liFrequency;
+	QueryPerformanceFrequency(&liFrequency);
+	m_llFrequency = liFrequency.QuadPart;
+	m_llSpinCounts = (LONGLONG)options->SpinMicroseconds * m_llFrequency / 1000000;
+}
+
+// Polling the OVERLAPPEDs directly needs no completion port. Every other mode reaps 
+// completions from the port.
+BOOL CIocpBackend::Open(HANDLE hFile, DWORD queueDepth)
+{
+	m_hFile = hFile;
+	m_ulEntries = queueDepth;
+	if (m_pOptions->CompletionMode == BENCHCM_POLLOVERLAPPED)
+	{
+		m_inFlight.reserve(queueDepth);
+		return TRUE;
+	}
+
+	m_hIOCP = CreateIoCompletionPort(hFile, NULL, 0, 0);
+	if (m_hIOCP.IsInvalid())
+		return FALSE;
+	m_cefEntries = HeapAlloc(GetProcessHeap(), 0, sizeof(OVERLAPPED_ENTRY) * queueDepth);
+	if ((LPOVERLAPPED_ENTRY)m_cefEntries == NULL)
+	{
+		SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+BOOL CIocpBackend::Submit(IoRequest* request)
+{
+	ZeroMemory(&request->Overlapped, sizeof(OVERLAPPED));
+	request->Overlapped.Offset = request->Offset.LowPart;
+	request->Overlapped.OffsetHigh = request->Offset.HighPart;
+
+	BOOL bOk;
+	if (request->Operation == IOREQ_TRIM)
+		bOk = IssueTrim(m_hFile, m_pOptions->TrimType, &request->Offset, request->Length, &request->Overlapped);
+	else if (request->Segments != NULL)
+		bOk = TransferSegments(m_hFile, request->Operation == IOREQ_WRITE, request->Segments, request->Length, &request->Overlapped);
+	else if (request->Operation == IOREQ_WRITE)
+		bOk = WriteFile(m_hFile, request->Buffer, request->Length, NULL, &request->Overlapped);
+	else
+		bOk = ReadFile(m_hFile, request->Buffer, request->Length, NULL, &request->Overlapped);
+	if (!bOk && GetLastError() != ERROR_IO_PENDING)
+		return FALSE;
+
+	// A request the call finished itself still queues its completion to the port.
+	request->Synchronous = bOk;
+	if (m_pOptions->CompletionMode == BENCHCM_POLLOVERLAPPED)
+		m_inFlight.push_back(request);
+	return TRUE;
+}
+
+// Polling modes look for completions without waiting; hybrid polls for the spin time before 
+// it blocks. Waiting is limited to milliseconds in every mode.
+BOOL CIocpBackend::Reap(IoRequest** requests, ULONG count, DWORD milliseconds, PULONG reaped, PULONGLONG calls)
+{
+	LARGE_INTEGER liStart;
+	QueryPerformanceCounter(&liStart);
+	if (count > m_ulEntries)
+		count = m_ulEntries;
+
+	for (;;)
+	{
+		LARGE_INTEGER liNow;
+		QueryPerformanceCounter(&liNow);
+		LONGLONG elapsed = liNow.QuadPart - liStart.QuadPart;
+		DWORD remaining = INFINITE;
+		if (milliseconds != INFINITE)
+		{
+			ULONGLONG elapsedMilliseconds = (ULONGLONG)elapsed * 1000 / m_llFrequency;
+			remaining = elapsedMilliseconds < milliseconds ? milliseconds - (DWORD)elapsedMilliseconds : 0;
+		}
+
+		DWORD mode = m_pOptions->CompletionMode;
+		ULONG removed = 0;
+		if (mode == BENCHCM_POLLOVERLAPPED)
+			removed = PollOverlappeds(requests, count);
+		else
+		{
+			DWORD timeout = remaining;
+			if (mode == BENCHCM_POLL || (mode == BENCHCM_HYBRID && elapsed < m_llSpinCounts))
+				timeout = 0;
+
+			LPOVERLAPPED_ENTRY entries = m_cefEntries;
+			++*calls;
+			if (!GetQueuedCompletionStatusEx(m_hIOCP, entries, count, &removed, timeout, FALSE))
+			{
+				if (GetLastError() != WAIT_TIMEOUT)
+					return FALSE;
+				removed = 0;
+			}
+			for (ULONG i = 0; i < removed; ++i)
+			{
+				requests[i] = (IoRequest*)entries[i].lpOverlapped;
+				Complete(requests[i], entries[i].dwNumberOfBytesTransferred);
+			}
+		}
+
+		if (removed || remaining == 0 || (m_pStatus != NULL && *(volatile const BOOL*)&m_pStatus->Canceled))
+		{
+			*reaped = removed;
+			return TRUE;
+		}
+	}
+}
+
+// Reads the status the kernel writes into each in-flight OVERLAPPED. No system call is made.
+ULONG CIocpBackend::PollOverlappeds(IoRequest** requests, ULONG count)
+{
+	ULONG removed = 0;
+	for (size_t i = 0; i < m_inFlight.size() && removed < count; )
+	{
+		IoRequest* request = m_inFlight[i];
+		if (*(volatile ULONG_PTR*)&request->Overlapped.Internal == STATUS_PENDING)
+		{
+			++i;
+			continue;
+		}
+		Complete(request, (DWORD)request->Overlapped.InternalHigh);
+		requests[removed++] = request;
+		m_inFlight[i] = m_inFlight.back();
+		m_inFlight.pop_back();
+	}
+	return removed;
+}
+
+// A finished request's status is already in its OVERLAPPED, so GetOverlappedResult only 
+// translates it; it is left out altogether on success.
+void CIocpBackend::Complete(IoRequest* request, DWORD bytesTransferred)
+{
+	request->BytesTransferred = bytesTransferred;
+	request->Error = ERROR_SUCCESS;
+	DWORD bytes;
+	if (request->Overlapped.Internal != 0 && !GetOverlappedResult(m_hFile, &request->Overlapped, &bytes, FALSE))
+		request->Error = GetLastError();
+}
+
+// Abandoned requests still complete, so Reap waits for them without regard to the run.
+void CIocpBackend::CancelAll()
+{
+	m_pStatus = NULL;
+	CancelIoEx(m_hFile, NULL);
+}
@@ -0,0 +1,51 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include <vector>
+#include "IoBackend.h"
+#include "ResourceHelper.h"
+
+struct OpOptions;
+struct Status;
+
+// Overlapped I/O on a handle opened with FILE_FLAG_OVERLAPPED. Completions are reaped the way 
+// OpOptions::CompletionMode asks: from a completion port, blocking, polling or both, or for 
+// BENCHCM_POLLOVERLAPPED straight from the OVERLAPPEDs with no port at all. A handle can only 
+// ever be bound to one port, so a handle should only be given to one CIocpBackend.
+class CIocpBackend : public IoBackend
+{
+public:
+	CIocpBackend(const OpOptions* options, const Status* status);
+
+	BOOL Open(HANDLE hFile, DWORD queueDepth);
+	BOOL Submit(IoRequest* request);
+	BOOL Reap(IoRequest** requests, ULONG count, DWORD milliseconds, PULONG reaped, PULONGLONG calls);
+	void CancelAll();
+
+private:
+	ULONG PollOverlappeds(IoRequest** requests, ULONG count);
+	void Complete(IoRequest* request, DWORD bytesTransferred);
+
+	const OpOptions* m_pOptions;
+	const Status* m_pStatus; // polling gives up when the run is canceled, until CancelAll
+	HANDLE m_hFile;
+	CEnsureCloseHandle m_hIOCP;
+	CEnsureHeapFree<LPOVERLAPPED_ENTRY> m_cefEntries;
+	ULONG m_ulEntries;
+	std::vector<IoRequest*> m_inFlight; // BENCHCM_POLLOVERLAPPED only
+	LONGLONG m_llSpinCounts;
+	LONGLONG m_llFrequency;
+};
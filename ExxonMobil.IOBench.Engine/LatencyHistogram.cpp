@@ -0,0 +1,40 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "LatencyHistogram.h"
+
+DWORD GetLatencyBucket(ULONGLONG microseconds)
+{
+	if (microseconds < LATENCY_LINEAR_BUCKETS)
+		return (DWORD)microseconds;
+
+	DWORD msb = 0;
+	ULONGLONG value = microseconds;
+	while (value >>= 1) ++msb;
+
+	DWORD subBucket = (DWORD)(microseconds >> (msb - LATENCY_SUB_BUCKET_BITS)) & ((1 << LATENCY_SUB_BUCKET_BITS) - 1);
+	DWORD bucket = LATENCY_LINEAR_BUCKETS + ((msb - 4) << LATENCY_SUB_BUCKET_BITS) + subBucket;
+	return bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1;
+}
+
+// Each histogram has a single writer, the loop that owns it, so a plain increment is enough.
+void RecordLatency(LatencyHistogram* histogram, ULONGLONG microseconds)
+{
+	++(histogram->Buckets[GetLatencyBucket(microseconds)]);
+}
+
+// For histograms several threads record into at once.
+void RecordLatencyInterlocked(LatencyHistogram* histogram, ULONGLONG microseconds)
+{
+	InterlockedIncrement64((volatile LONGLONG*)&histogram->Buckets[GetLatencyBucket(microseconds)]);
+}
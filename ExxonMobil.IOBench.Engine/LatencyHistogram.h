@@ -0,0 +1,32 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+
+// Log-linear histogram of latencies in microseconds. Values below 16us get
+// their own bucket; above that each power of two is split into 8 buckets.
+// Layout is shared with the managed LatencyHistogram class.
+#define LATENCY_BUCKETS        256
+#define LATENCY_LINEAR_BUCKETS 16
+#define LATENCY_SUB_BUCKET_BITS 3
+
+struct LatencyHistogram
+{
+	ULONGLONG Buckets[LATENCY_BUCKETS];
+};
+
+DWORD GetLatencyBucket(ULONGLONG microseconds);
+void RecordLatency(LatencyHistogram* histogram, ULONGLONG microseconds);
+void RecordLatencyInterlocked(LatencyHistogram* histogram, ULONGLONG microseconds);
@@ -0,0 +1,67 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include "EmulatedDevice.h"
+
+// Values are shared with the managed enums.
+#define BENCHOP_WRITE 1
+#define BENCHOP_READ  2
+#define BENCHOP_TRIM  3
+#define BENCHAP_SEQUENTIAL 1
+#define BENCHAP_RANDOM     2
+#define BENCHAP_REPLAY     3
+#define BENCHCM_BLOCK          0
+#define BENCHCM_POLL           1
+#define BENCHCM_HYBRID         2
+#define BENCHCM_POLLOVERLAPPED 3
+#define BENCHTRIM_PUNCH   0
+#define BENCHTRIM_DISCARD 1
+#define BENCHLAYOUT_SEGMENT    0
+#define BENCHLAYOUT_INTERLEAVE 1
+#define BENCHSG_CONTIGUOUS 0
+#define BENCHSG_SCATTERED  1
+#define BENCHSTREAM_ROUNDROBIN 0
+#define BENCHSTREAM_RANDOM     1
+
+// Tuning and placement options for the transfer loops. Layout is shared with the managed 
+// NativeOpOptions.
+struct OpOptions
+{
+	DWORD SubmitBatch;       // requests submitted together, 0 or 1 submits as soon as a slot frees
+	BOOL AdaptiveBatch;      // size batches by the completions reaped per wait
+	BOOL StrictAsync;        // count requests whose submit call blocked before returning pending as synchronous
+	DWORD CompletionMode;    // BENCHCM_*
+	DWORD SpinMicroseconds;  // BENCHCM_HYBRID polling time before blocking
+	DWORD NumaNode;          // node for buffers and the issuing thread, NUMA_NO_PREFERRED_NODE for none
+	DWORD CpuGroup;          // processor group of CpuMask
+	ULONGLONG CpuMask;       // processors to bind to, 0 binds to every processor of NumaNode
+	DWORD TrimPercent;       // share of write requests issued as trims instead
+	DWORD TrimType;          // BENCHTRIM_*
+	DWORD VerifyThreads;     // threads verifying asynchronous reads, 0 verifies in the completion loop
+	DWORD Sharers;           // loops transferring one file through their own handles, 0 or 1 when alone
+	DWORD Sharer;            // index of this loop among the sharers, also the StatBlock it publishes to
+	DWORD SharedLayout;      // BENCHLAYOUT_*, how the sharers divide the file
+	BOOL LockRanges;         // hold an exclusive byte-range lock over each request
+	BOOL Append;             // write at the end of the file whatever the request offset
+	ULONGLONG RateBytesPerSec; // average rate the loop issues requests at, 0 for as fast as it can
+	BOOL ScatterGather;      // transfer each block as one page per segment with ReadFileScatter and WriteFileGather
+	DWORD SegmentLayout;     // BENCHSG_*, where the pages of a block sit in memory
+	DWORD Streams;           // sequential cursors over equal regions of the file, 0 for one cursor from the start
+	DWORD StreamOrder;       // BENCHSTREAM_*, how the next request picks its stream
+	DWORD StreamStride;      // blocks each stream advances per request, 0 or 1 for contiguous
+	BOOL StreamReverse;      // walk each stream's region from its end
+	EmulatedDevice Device;   // device the loop transfers to instead of its file, Type EMULATED_NONE for the file
+};
@@ -0,0 +1,55 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "OpOptions.h"
+#include "Status.h"
+#include "Pacer.h"
+
+CRatePacer::CRatePacer(const OpOptions* options)
+	: m_rate(options->RateBytesPerSec), m_issued(0), m_started(FALSE)
+{
+	QueryPerformanceFrequency(&m_liFrequency);
+}
+
+// Time until the bytes issued so far are due at the paced rate. An unpaced loop is always due.
+ULONGLONG CRatePacer::MicrosecondsUntilDue()
+{
+	if (m_rate == 0)
+		return 0;
+
+	LARGE_INTEGER liNow;
+	QueryPerformanceCounter(&liNow);
+	if (!m_started)
+	{
+		m_liStart = liNow;
+		m_started = TRUE;
+		return 0;
+	}
+
+	double elapsed = (double)(liNow.QuadPart - m_liStart.QuadPart) / m_liFrequency.QuadPart;
+	double due = (double)m_issued / m_rate;
+	return due > elapsed ? (ULONGLONG)((due - elapsed) * 1000000) : 0;
+}
+
+// Sleeps whole milliseconds while the wait is long enough for them and yields for the rest.
+void CRatePacer::WaitUntilDue(const Status* status)
+{
+	ULONGLONG microseconds;
+	while ((microseconds = MicrosecondsUntilDue()) != 0 && !status->Canceled)
+		Sleep(microseconds < 1000 ? 0 : (DWORD)(microseconds / 1000));
+}
+
+void CRatePacer::Issued(ULONGLONG bytes)
+{
+	m_issued += bytes;
+}
@@ -0,0 +1,39 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+
+struct OpOptions;
+struct Status;
+
+// Holds a transfer loop to an average of OpOptions::RateBytesPerSec measured from its first 
+// request. A loop that falls behind, for instance while its requests queue behind another 
+// workload, issues at full speed until it has caught up.
+class CRatePacer
+{
+public:
+	CRatePacer(const OpOptions* options);
+
+	ULONGLONG MicrosecondsUntilDue();
+	void WaitUntilDue(const Status* status);
+	void Issued(ULONGLONG bytes);
+
+private:
+	ULONGLONG m_rate;
+	ULONGLONG m_issued;
+	BOOL m_started;
+	LARGE_INTEGER m_liStart;
+	LARGE_INTEGER m_liFrequency;
+};
@@ -0,0 +1,40 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "PerfCount.h"
+
+void StartPerfCount(PLARGE_INTEGER pliStart)
+{
+	QueryPerformanceCounter(pliStart);
+}
+
+void StopPerfCount(PLARGE_INTEGER pliStart, PULONGLONG duration)
+{
+	LARGE_INTEGER liStop;
+	QueryPerformanceCounter(&liStop);
+	*duration = liStop.QuadPart - pliStart->QuadPart;
+}
+
+// Accumulators are counters of the calling thread's own worker block, which no other thread 
+// writes.
+void StopAndAccumPerfCount(PLARGE_INTEGER pliStart, PULONGLONG accumulator)
+{
+	ULONGLONG liDuration;
+	StopPerfCount(pliStart, &liDuration);
+	*accumulator += liDuration;
+}
+
+ULONGLONG PerfCountToMicroseconds(LONGLONG count, LONGLONG frequency)
+{
+	return (ULONGLONG)(count * 1000000 / frequency);
+}
@@ -0,0 +1,72 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "OpOptions.h"
+#include "Placement.h"
+
+CThreadPlacement::CThreadPlacement()
+	: m_bApplied(FALSE)
+{
+}
+
+CThreadPlacement::~CThreadPlacement()
+{
+	Restore();
+}
+
+BOOL CThreadPlacement::Apply(const OpOptions* options)
+{
+	GROUP_AFFINITY gaAffinity;
+	ZeroMemory(&gaAffinity, sizeof(gaAffinity));
+
+	// An explicit CPU list wins over the processors of the NUMA node.
+	if (options->CpuMask != 0)
+	{
+		gaAffinity.Group = (WORD)options->CpuGroup;
+		gaAffinity.Mask = (KAFFINITY)options->CpuMask;
+	}
+	else if (options->NumaNode != NUMA_NO_PREFERRED_NODE)
+	{
+		if (!GetNumaNodeProcessorMaskEx((USHORT)options->NumaNode, &gaAffinity))
+			return FALSE;
+	}
+	else
+		return TRUE;
+
+	if (!SetThreadGroupAffinity(GetCurrentThread(), &gaAffinity, &m_gaPrevious))
+		return FALSE;
+	m_bApplied = TRUE;
+	return TRUE;
+}
+
+void CThreadPlacement::Restore()
+{
+	if (m_bApplied)
+	{
+		SetThreadGroupAffinity(GetCurrentThread(), &m_gaPrevious, NULL);
+		m_bApplied = FALSE;
+	}
+}
+
+// Commits a transfer buffer on the requested NUMA node. The pages are touched from the 
+// bound thread so they are not left to land wherever first use happens to be.
+PVOID AllocateBuffer(SIZE_T size, const OpOptions* options)
+{
+	if (options->NumaNode == NUMA_NO_PREFERRED_NODE)
+		return VirtualAlloc(NULL, size, MEM_COMMIT, PAGE_READWRITE);
+
+	PVOID pBuffer = VirtualAllocExNuma(GetCurrentProcess(), NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, options->NumaNode);
+	if (pBuffer != NULL)
+		ZeroMemory(pBuffer, size);
+	return pBuffer;
+}
@@ -0,0 +1,110 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "OpOptions.h"
+#include "Segments.h"
+#include "DataPattern.h"
+
+static DWORD GetPageSize()
+{
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return si.dwPageSize;
+}
+
+CSegmentMap::CSegmentMap()
+	: m_dwPageSize(0), m_dwPages(0)
+{
+}
+
+// Scattered placement needs a spare page for every page in use.
+SIZE_T CSegmentMap::RegionSize(DWORD bufferCount, DWORD blockSize, DWORD layout)
+{
+	SIZE_T size = (SIZE_T)blockSize * bufferCount;
+	return layout == BENCHSG_SCATTERED ? size * 2 : size;
+}
+
+BOOL CSegmentMap::Initialize(PVOID region, DWORD bufferCount, DWORD blockSize, DWORD layout)
+{
+	m_dwPageSize = GetPageSize();
+	if (blockSize == 0 || blockSize % m_dwPageSize != 0)
+	{
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+	m_dwPages = blockSize / m_dwPageSize;
+
+	m_segments = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(FILE_SEGMENT_ELEMENT) * (m_dwPages + 1) * bufferCount);
+	if ((FILE_SEGMENT_ELEMENT*)m_segments == NULL)
+		return FALSE;
+
+	PBYTE pRegion = (PBYTE)region;
+	for (DWORD buffer = 0; buffer < bufferCount; ++buffer)
+	{
+		FILE_SEGMENT_ELEMENT* segments = Segments(buffer);
+		for (DWORD page = 0; page < m_dwPages; ++page)
+		{
+			SIZE_T regionPage = layout == BENCHSG_SCATTERED
+				? ((SIZE_T)page * bufferCount + buffer) * 2
+				: (SIZE_T)buffer * m_dwPages + page;
+			segments[page].Buffer = PtrToPtr64(pRegion + regionPage * m_dwPageSize);
+		}
+		// The terminating element stays NULL.
+	}
+	return TRUE;
+}
+
+FILE_SEGMENT_ELEMENT* CSegmentMap::Segments(DWORD buffer)
+{
+	return (FILE_SEGMENT_ELEMENT*)m_segments + (SIZE_T)buffer * (m_dwPages + 1);
+}
+
+// The data pattern is a function of the file offset, so each page is filled and checked 
+// against the offset it lands at.
+void CSegmentMap::Fill(DWORD buffer, const LARGE_INTEGER* pliOffset, CDataPattern& pattern, BOOL randomData)
+{
+	FILE_SEGMENT_ELEMENT* segments = Segments(buffer);
+	LARGE_INTEGER liPageOffset = *pliOffset;
+	for (DWORD page = 0; page < m_dwPages; ++page, liPageOffset.QuadPart += m_dwPageSize)
+		pattern.Fill(Ptr64ToPtr(segments[page].Buffer), m_dwPageSize, &liPageOffset, randomData);
+}
+
+BOOL CSegmentMap::Verify(DWORD buffer, const LARGE_INTEGER* pliOffset)
+{
+	FILE_SEGMENT_ELEMENT* segments = Segments(buffer);
+	LARGE_INTEGER liPageOffset = *pliOffset;
+	for (DWORD page = 0; page < m_dwPages; ++page, liPageOffset.QuadPart += m_dwPageSize)
+		if (!CDataPattern::Verify(Ptr64ToPtr(segments[page].Buffer), m_dwPageSize, &liPageOffset))
+			return FALSE;
+	return TRUE;
+}
+
+BOOL TransferSegments(HANDLE hFile, BOOL write, FILE_SEGMENT_ELEMENT* segments, DWORD length, LPOVERLAPPED overlapped)
+{
+	if (write)
+		return WriteFileGather(hFile, segments, length, NULL, overlapped);
+	return ReadFileScatter(hFile, segments, length, NULL, overlapped);
+}
+
+// Scatter and gather requests are always overlapped. The synchronous loop issues each one 
+// with an event and waits for it before moving on.
+BOOL TransferSegmentsAndWait(HANDLE hFile, BOOL write, FILE_SEGMENT_ELEMENT* segments, DWORD length, const LARGE_INTEGER* pliOffset, HANDLE hEvent, PDWORD bytesTransferred)
+{
+	OVERLAPPED overlapped = { 0 };
+	overlapped.Offset = pliOffset->LowPart;
+	overlapped.OffsetHigh = pliOffset->HighPart;
+	overlapped.hEvent = hEvent;
+	if (!TransferSegments(hFile, write, segments, length, &overlapped) && GetLastError() != ERROR_IO_PENDING)
+		return FALSE;
+	return GetOverlappedResult(hFile, &overlapped, bytesTransferred, TRUE);
+}
@@ -0,0 +1,45 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include "ResourceHelper.h"
+
+class CDataPattern;
+
+// Describes the transfer buffers of a loop as the page lists ReadFileScatter and 
+// WriteFileGather take: one FILE_SEGMENT_ELEMENT per system page and a NULL terminator. 
+// Contiguous placement lists the pages of each buffer in order. Scattered placement 
+// interleaves the buffers page by page and leaves a spare page between neighbours, so no two 
+// segments of a request are adjacent in memory.
+class CSegmentMap
+{
+public:
+	CSegmentMap();
+
+	static SIZE_T RegionSize(DWORD bufferCount, DWORD blockSize, DWORD layout);
+	BOOL Initialize(PVOID region, DWORD bufferCount, DWORD blockSize, DWORD layout);
+	FILE_SEGMENT_ELEMENT* Segments(DWORD buffer);
+
+	void Fill(DWORD buffer, const LARGE_INTEGER* pliOffset, CDataPattern& pattern, BOOL randomData);
+	BOOL Verify(DWORD buffer, const LARGE_INTEGER* pliOffset);
+
+private:
+	CEnsureHeapFree<FILE_SEGMENT_ELEMENT*> m_segments;
+	DWORD m_dwPageSize;
+	DWORD m_dwPages;
+};
+
+BOOL TransferSegments(HANDLE hFile, BOOL write, FILE_SEGMENT_ELEMENT* segments, DWORD length, LPOVERLAPPED overlapped);
+BOOL TransferSegmentsAndWait(HANDLE hFile, BOOL write, FILE_SEGMENT_ELEMENT* segments, DWORD length, const LARGE_INTEGER* pliOffset, HANDLE hEvent, PDWORD bytesTransferred);
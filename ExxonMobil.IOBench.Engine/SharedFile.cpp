@@ -0,0 +1,84 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "OpOptions.h"
+#include "Status.h"
+#include "SharedFile.h"
+
+BOOL IsSharedFile(const OpOptions* options)
+{
+	return options->Sharers > 1;
+}
+
+DWORD GetStatWorker(const OpOptions* options)
+{
+	return IsSharedFile(options) ? options->Sharer : STAT_LOOP_WORKER;
+}
+
+// Places a block of this loop in the file. A segmented file gives each sharer its own run of 
+// blocks; an interleaved file deals blocks to the sharers in turn, so neighbouring blocks are 
+// always written through different handles.
+void MapSharedOffset(const OpOptions* options, ULONGLONG blocks, DWORD blockSize, const LARGE_INTEGER* pliLoopOffset, PLARGE_INTEGER pliFileOffset)
+{
+	if (!IsSharedFile(options))
+	{
+		*pliFileOffset = *pliLoopOffset;
+		return;
+	}
+
+	ULONGLONG block = (ULONGLONG)pliLoopOffset->QuadPart / blockSize;
+	if (options->SharedLayout == BENCHLAYOUT_INTERLEAVE)
+		block = block * options->Sharers + options->Sharer;
+	else
+		block += blocks * options->Sharer;
+	pliFileOffset->QuadPart = (LONGLONG)(block * blockSize);
+}
+
+// Sharers record into the histograms of the one Status they report to, so their updates must 
+// not be lost to each other.
+void RecordLoopLatency(LatencyHistogram* histogram, ULONGLONG microseconds, const OpOptions* options)
+{
+	if (IsSharedFile(options))
+		RecordLatencyInterlocked(histogram, microseconds);
+	else
+		RecordLatency(histogram, microseconds);
+}
+
+BOOL CRangeLock::Initialize()
+{
+	m_hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	return !m_hEvent.IsInvalid();
+}
+
+BOOL CRangeLock::Lock(HANDLE hFile, const LARGE_INTEGER* pliOffset, DWORD length)
+{
+	// Setting the low bit of the event keeps the completion off the port.
+	OVERLAPPED overlapped = { 0 };
+	overlapped.Offset = pliOffset->LowPart;
+	overlapped.OffsetHigh = pliOffset->HighPart;
+	overlapped.hEvent = (HANDLE)((ULONG_PTR)(HANDLE)m_hEvent | 1);
+	if (LockFileEx(hFile, LOCKFILE_EXCLUSIVE_LOCK, 0, length, 0, &overlapped))
+		return TRUE;
+	if (GetLastError() != ERROR_IO_PENDING)
+		return FALSE;
+	DWORD bytesTransferred;
+	return GetOverlappedResult(hFile, &overlapped, &bytesTransferred, TRUE);
+}
+
+BOOL CRangeLock::Unlock(HANDLE hFile, const LARGE_INTEGER* pliOffset, DWORD length)
+{
+	OVERLAPPED overlapped = { 0 };
+	overlapped.Offset = pliOffset->LowPart;
+	overlapped.OffsetHigh = pliOffset->HighPart;
+	return UnlockFileEx(hFile, 0, length, 0, &overlapped);
+}
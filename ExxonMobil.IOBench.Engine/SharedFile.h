@@ -0,0 +1,39 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include "ResourceHelper.h"
+
+struct OpOptions;
+struct Status;
+struct LatencyHistogram;
+
+BOOL IsSharedFile(const OpOptions* options);
+DWORD GetStatWorker(const OpOptions* options);
+void MapSharedOffset(const OpOptions* options, ULONGLONG blocks, DWORD blockSize, const LARGE_INTEGER* pliLoopOffset, PLARGE_INTEGER pliFileOffset);
+void RecordLoopLatency(LatencyHistogram* histogram, ULONGLONG microseconds, const OpOptions* options);
+
+// Exclusive byte-range locks held over the requests of a shared file. Locks are waited for on 
+// a private event so a handle bound to a completion port never queues their completions.
+class CRangeLock
+{
+public:
+	BOOL Initialize();
+	BOOL Lock(HANDLE hFile, const LARGE_INTEGER* pliOffset, DWORD length);
+	BOOL Unlock(HANDLE hFile, const LARGE_INTEGER* pliOffset, DWORD length);
+
+private:
+	CEnsureCloseHandle m_hEvent;
+};
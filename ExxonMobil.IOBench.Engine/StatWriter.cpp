@@ -0,0 +1,59 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "StatWriter.h"
+
+#include <intrin.h>
+
+// Counting resumes from what the block already holds, so a worker that runs once per file
+// keeps adding to the same totals.
+CStatWriter::CStatWriter(Status* status, DWORD worker)
+	: m_pBlock(status->Workers + worker), m_counters(m_pBlock->Counters)
+{
+}
+
+CStatWriter::~CStatWriter()
+{
+	Publish();
+}
+
+StatCounters* CStatWriter::operator->()
+{
+	return &m_counters;
+}
+
+const StatCounters& CStatWriter::Counters() const
+{
+	return m_counters;
+}
+
+// x86 and x64 keep stores in program order, so only the compiler has to be stopped from 
+// moving the copy out from between the two sequence increments.
+void CStatWriter::Publish()
+{
+	m_pBlock->Sequence = m_pBlock->Sequence + 1;
+	_ReadWriteBarrier();
+	m_pBlock->Counters = m_counters;
+	_ReadWriteBarrier();
+	m_pBlock->Sequence = m_pBlock->Sequence + 1;
+}
+
+// Progress is read concurrently by the managed side. Publishing once per batch hands readers
+// every counter the loop has updated since the last batch as one consistent set.
+void AddProgress(CStatWriter& stats, ULONGLONG blocks, ULONGLONG bytes, ULONGLONG trimmedBytes)
+{
+	stats->BlocksTransferred += blocks;
+	stats->BytesTransferred += bytes;
+	stats->TrimmedBytes += trimmedBytes;
+	stats.Publish();
+}
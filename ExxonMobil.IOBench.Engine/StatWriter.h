@@ -0,0 +1,37 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include "Status.h"
+
+// Keeps one worker's counters where only that worker touches them and publishes a copy to
+// its StatBlock. Publishing never contends with other workers or with readers, so the
+// loops can publish after every completion batch.
+class CStatWriter
+{
+public:
+	CStatWriter(Status* status, DWORD worker);
+	~CStatWriter();
+
+	StatCounters* operator->();
+	const StatCounters& Counters() const;
+	void Publish();
+
+private:
+	StatBlock* m_pBlock;
+	StatCounters m_counters;
+};
+
+void AddProgress(CStatWriter& stats, ULONGLONG blocks, ULONGLONG bytes, ULONGLONG trimmedBytes);
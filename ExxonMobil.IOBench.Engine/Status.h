@@ -0,0 +1,79 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include "LatencyHistogram.h"
+#include "CpuUsage.h"
+
+#define STAT_CACHE_LINE    64
+#define STAT_LOOP_WORKER   0 // verifier threads take the blocks after it
+#define STATUS_MAX_WORKERS (1 + MAXIMUM_WAIT_OBJECTS)
+#define STATUS_MAX_STREAMS 64
+
+// Counters kept by a single worker, either the transfer loop or one verifier thread.
+struct StatCounters
+{
+    ULONGLONG BlocksTransferred;
+    ULONGLONG CompletedAsync;
+    ULONGLONG CompletedSync;
+    ULONGLONG BytesTransferred;
+    ULONGLONG TrimmedBytes;
+    ULONGLONG VerifiedBytes;
+
+    ULONGLONG ReadWriteFilePerfCounts;
+    ULONGLONG GetQueuedCompletionStatusExPerfCounts;
+    ULONGLONG ScheduleLagPerfCounts;
+    ULONGLONG VerifyPerfCounts;
+
+    ULONGLONG SubmitCalls;
+    ULONGLONG CompletionCalls;
+
+    ULONGLONG InFlight; // requests outstanding after the last completion batch
+};
+
+// A worker's published counters. The sequence is odd while the worker copies in a new set,
+// so a reader retries until it sees the same even value before and after its own copy.
+// The managed side owns this memory and cannot align it; the leading pad is what keeps a
+// worker's writes off its neighbour's cache lines.
+struct StatBlock
+{
+    BYTE Padding[STAT_CACHE_LINE];
+    volatile LONG Sequence;
+    DWORD Reserved;
+    StatCounters Counters;
+};
+
+struct Status
+{
+    BOOL Canceled;
+    DWORD Reserved;
+
+    LONGLONG VerifyBacklog;
+    LONGLONG VerifyBacklogPeak;
+    LatencyHistogram Latency;
+    LatencyHistogram TrimLatency;
+
+    // CPU of the verifier threads, added by the pool as each thread exits. The managed side 
+    // adds it to the CPU of the thread that drove the transfer.
+    CpuUsage VerifierCpu;
+
+    // Totals of each cursor of a multi-stream loop. Only the loop writes them and the 
+    // managed side reads them once the loop is done.
+    ULONGLONG StreamBytes[STATUS_MAX_STREAMS];
+    ULONGLONG StreamLatencyMicroseconds[STATUS_MAX_STREAMS]; // summed over the stream's requests
+    ULONGLONG StreamFinishMicroseconds[STATUS_MAX_STREAMS];  // from the start of the loop to the stream's last completion
+
+    StatBlock Workers[STATUS_MAX_WORKERS];
+};
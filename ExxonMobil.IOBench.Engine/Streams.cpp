@@ -0,0 +1,96 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "OpOptions.h"
+#include "PerfCount.h"
+#include "Streams.h"
+
+#include <time.h>
+
+CStreamCursors::CStreamCursors()
+	: m_dwStreams(0), m_dwOrder(BENCHSTREAM_ROUNDROBIN), m_dwStride(1), m_bReverse(FALSE), m_regionBlocks(0), 
+	  m_dwActive(0), m_dwNext(0), m_pStatus(NULL)
+{
+}
+
+BOOL CStreamCursors::Initialize(const OpOptions* options, ULONGLONG blocks, Status* status)
+{
+	if (options->Streams == 0)
+		return TRUE;
+
+	DWORD stride = options->StreamStride ? options->StreamStride : 1;
+	if (options->Streams > STATUS_MAX_STREAMS || blocks % ((ULONGLONG)options->Streams * stride) != 0)
+	{
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	m_dwStreams = options->Streams;
+	m_dwOrder = options->StreamOrder;
+	m_dwStride = stride;
+	m_bReverse = options->StreamReverse;
+	m_regionBlocks = blocks / m_dwStreams;
+	m_dwActive = m_dwStreams;
+	m_dwNext = 0;
+	m_engine = std::tr1::mt19937_64(time(NULL));
+	m_pStatus = status;
+	for (DWORD i = 0; i < m_dwStreams; ++i)
+	{
+		m_issued[i] = 0;
+		m_active[i] = i;
+		status->StreamBytes[i] = 0;
+		status->StreamLatencyMicroseconds[i] = 0;
+		status->StreamFinishMicroseconds[i] = 0;
+	}
+
+	QueryPerformanceFrequency(&m_liFrequency);
+	QueryPerformanceCounter(&m_liStart);
+	return TRUE;
+}
+
+BOOL CStreamCursors::IsEnabled() const
+{
+	return m_dwStreams != 0;
+}
+
+// Returns the stream the next request belongs to and places it in the file. Every stream 
+// holds the same number of blocks, so taking turns never reaches a finished stream before 
+// the operation is done.
+DWORD CStreamCursors::Next(DWORD blockSize, PLARGE_INTEGER pliOffset)
+{
+	DWORD stream;
+	if (m_dwOrder == BENCHSTREAM_RANDOM)
+	{
+		DWORD slot = (DWORD)(m_engine() % m_dwActive);
+		stream = m_active[slot];
+		if (m_issued[stream] + 1 == m_regionBlocks)
+			m_active[slot] = m_active[--m_dwActive];
+	}
+	else
+		stream = m_dwNext++ % m_dwStreams;
+
+	ULONGLONG position = m_issued[stream]++;
+	ULONGLONG perPass = m_regionBlocks / m_dwStride;
+	ULONGLONG block = (position % perPass) * m_dwStride + position / perPass;
+	if (m_bReverse)
+		block = m_regionBlocks - 1 - block;
+	pliOffset->QuadPart = (LONGLONG)((stream * m_regionBlocks + block) * blockSize);
+	return stream;
+}
+
+void CStreamCursors::Completed(DWORD stream, DWORD bytes, ULONGLONG latency, const LARGE_INTEGER* pliCompleted)
+{
+	m_pStatus->StreamBytes[stream] += bytes;
+	m_pStatus->StreamLatencyMicroseconds[stream] += latency;
+	m_pStatus->StreamFinishMicroseconds[stream] = PerfCountToMicroseconds(pliCompleted->QuadPart - m_liStart.QuadPart, m_liFrequency.QuadPart);
+}
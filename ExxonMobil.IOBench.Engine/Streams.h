@@ -0,0 +1,50 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include <random>
+#include "Status.h"
+
+struct OpOptions;
+
+// Splits a sequential operation into OpOptions::Streams cursors, each walking its own equal 
+// region of the file forward or backward. A stride of S visits every Sth block of the region 
+// in S passes, so every block is still transferred exactly once. Streams are served in turn, 
+// or picked at random among those with blocks left. Each stream's totals go to the Status.
+class CStreamCursors
+{
+public:
+	CStreamCursors();
+
+	BOOL Initialize(const OpOptions* options, ULONGLONG blocks, Status* status);
+	BOOL IsEnabled() const;
+	DWORD Next(DWORD blockSize, PLARGE_INTEGER pliOffset);
+	void Completed(DWORD stream, DWORD bytes, ULONGLONG latency, const LARGE_INTEGER* pliCompleted);
+
+private:
+	DWORD m_dwStreams;
+	DWORD m_dwOrder;
+	DWORD m_dwStride;
+	BOOL m_bReverse;
+	ULONGLONG m_regionBlocks;
+	ULONGLONG m_issued[STATUS_MAX_STREAMS];
+	DWORD m_active[STATUS_MAX_STREAMS];
+	DWORD m_dwActive;
+	DWORD m_dwNext;
+	std::tr1::mt19937_64 m_engine;
+	Status* m_pStatus;
+	LARGE_INTEGER m_liStart;
+	LARGE_INTEGER m_liFrequency;
+};
@@ -0,0 +1,91 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "OpOptions.h"
+#include "Trim.h"
+#include "Segments.h"
+#include "SyncBackend.h"
+
+CSyncBackend::CSyncBackend(const OpOptions* options) :
+	m_pOptions(options),
+	m_hFile(INVALID_HANDLE_VALUE)
+{
+	m_liPointer.QuadPart = 0;
+}
+
+// Scatter and gather requests are always overlapped, so they are waited for on an event.
+BOOL CSyncBackend::Open(HANDLE hFile, DWORD queueDepth)
+{
+	m_hFile = hFile;
+	if (m_pOptions->ScatterGather)
+	{
+		m_hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+		if (m_hEvent.IsInvalid())
+			return FALSE;
+	}
+	m_liPointer.QuadPart = 0;
+	return SetFilePointer(hFile, 0, NULL, FILE_BEGIN) != INVALID_SET_FILE_POINTER;
+}
+
+// Trims and page lists name their offset and leave the file pointer where it was.
+BOOL CSyncBackend::Submit(IoRequest* request)
+{
+	DWORD bytes = 0;
+	BOOL bOk;
+	if (request->Operation == IOREQ_TRIM)
+		bOk = IssueTrim(m_hFile, m_pOptions->TrimType, &request->Offset, request->Length, NULL);
+	else if (request->Segments != NULL)
+		bOk = TransferSegmentsAndWait(m_hFile, request->Operation == IOREQ_WRITE, request->Segments, request->Length, &request->Offset, m_hEvent, &bytes);
+	else
+	{
+		if (request->Offset.QuadPart != -1 && request->Offset.QuadPart != m_liPointer.QuadPart)
+		{
+			if (!SetFilePointerEx(m_hFile, request->Offset, NULL, FILE_BEGIN))
+				return FALSE;
+			m_liPointer = request->Offset;
+		}
+		bOk = request->Operation == IOREQ_WRITE
+			? WriteFile(m_hFile, request->Buffer, request->Length, &bytes, NULL)
+			: ReadFile(m_hFile, request->Buffer, request->Length, &bytes, NULL);
+		m_liPointer.QuadPart += bytes;
+	}
+
+	request->BytesTransferred = bytes;
+	request->Error = bOk ? ERROR_SUCCESS : GetLastError();
+	request->Synchronous = TRUE;
+	m_completed.push(request);
+	return TRUE;
+}
+
+BOOL CSyncBackend::Reap(IoRequest** requests, ULONG count, DWORD milliseconds, PULONG reaped, PULONGLONG calls)
+{
+	if (m_completed.empty())
+	{
+		SetLastError(ERROR_NO_MORE_ITEMS);
+		return FALSE;
+	}
+
+	ULONG removed = 0;
+	for (; removed < count && !m_completed.empty(); ++removed)
+	{
+		requests[removed] = m_completed.front();
+		m_completed.pop();
+	}
+
+	*reaped = removed;
+	return TRUE;
+}
+
+void CSyncBackend::CancelAll()
+{
+}
@@ -0,0 +1,44 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include <queue>
+#include "IoBackend.h"
+#include "ResourceHelper.h"
+
+struct OpOptions;
+
+// Blocking I/O on a handle opened without FILE_FLAG_OVERLAPPED. Each request finishes inside
+// Submit, so the queue depth is effectively 1; Reap just hands back what already completed.
+// Transfers go through the file pointer, which is only moved when a request does not start 
+// where the last one ended. A request at offset -1 writes wherever the pointer is, which an 
+// append only handle takes as the end of the file.
+class CSyncBackend : public IoBackend
+{
+public:
+	CSyncBackend(const OpOptions* options);
+
+	BOOL Open(HANDLE hFile, DWORD queueDepth);
+	BOOL Submit(IoRequest* request);
+	BOOL Reap(IoRequest** requests, ULONG count, DWORD milliseconds, PULONG reaped, PULONGLONG calls);
+	void CancelAll();
+
+private:
+	const OpOptions* m_pOptions;
+	HANDLE m_hFile;
+	CEnsureCloseHandle m_hEvent;
+	LARGE_INTEGER m_liPointer;
+	std::queue<IoRequest*> m_completed;
+};
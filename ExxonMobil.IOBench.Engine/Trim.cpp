@@ -0,0 +1,56 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "OpOptions.h"
+#include "Trim.h"
+
+#include <winioctl.h>
+
+// Picks the requests of a write workload that are issued as trims instead. Credit accumulates 
+// per request so trims are spread evenly at TrimPercent of the requests.
+BOOL IsTrimRequest(DWORD op, const OpOptions* options, PDWORD trimCredit)
+{
+	if (op == BENCHOP_TRIM)
+		return TRUE;
+	if (op != BENCHOP_WRITE || options->TrimPercent == 0)
+		return FALSE;
+
+	*trimCredit += options->TrimPercent;
+	if (*trimCredit < 100)
+		return FALSE;
+	*trimCredit -= 100;
+	return TRUE;
+}
+
+// Issues a trim of one range the same way WriteFile issues a write. Punching a hole releases 
+// the range from a sparse file. A file level trim leaves the range allocated with undefined 
+// contents and only tells the device the blocks are unused. Both complete with no bytes 
+// transferred.
+BOOL IssueTrim(HANDLE hFile, DWORD trimType, const LARGE_INTEGER* pliOffset, DWORD length, LPOVERLAPPED overlapped)
+{
+	DWORD bytesReturned;
+	if (trimType == BENCHTRIM_DISCARD)
+	{
+		FILE_LEVEL_TRIM trim;
+		ZeroMemory(&trim, sizeof(trim));
+		trim.NumRanges = 1;
+		trim.Ranges[0].Offset = pliOffset->QuadPart;
+		trim.Ranges[0].Length = length;
+		return DeviceIoControl(hFile, FSCTL_FILE_LEVEL_TRIM, &trim, sizeof(trim), NULL, 0, &bytesReturned, overlapped);
+	}
+
+	FILE_ZERO_DATA_INFORMATION zeroData;
+	zeroData.FileOffset = *pliOffset;
+	zeroData.BeyondFinalZero.QuadPart = pliOffset->QuadPart + length;
+	return DeviceIoControl(hFile, FSCTL_SET_ZERO_DATA, &zeroData, sizeof(zeroData), NULL, 0, &bytesReturned, overlapped);
+}
@@ -15,14 +15,7 @@
 
 #include <Windows.h>
 
-struct Status
-{
-    BOOL Canceled;
+struct OpOptions;
 
-    DWORD BlocksTransferred;
-    DWORD CompletedAsync;
-    DWORD CompletedSync;
-
-    ULONGLONG ReadWriteFilePerfCounts;
-    ULONGLONG GetQueuedCompletionStatusExPerfCounts;
-};
\ No newline at end of file
+BOOL IsTrimRequest(DWORD op, const OpOptions* options, PDWORD trimCredit);
+BOOL IssueTrim(HANDLE hFile, DWORD trimType, const LARGE_INTEGER* pliOffset, DWORD length, LPOVERLAPPED overlapped);
@@ -0,0 +1,165 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "Status.h"
+#include "StatWriter.h"
+#include "Verifier.h"
+#include "DataPattern.h"
+
+CVerifierPool::CVerifierPool()
+	: m_dwThreads(0), m_pBuffers(NULL), m_dwBlockSize(0), m_pStatus(NULL), m_lWorkers(STAT_LOOP_WORKER), m_lFailed(FALSE)
+{
+	InitializeSListHead(&m_pending);
+	InitializeSListHead(&m_free);
+}
+
+CVerifierPool::~CVerifierPool()
+{
+	Stop();
+}
+
+BOOL CVerifierPool::Start(DWORD threads, PVOID buffers, DWORD bufferCount, DWORD blockSize, Status* status)
+{
+	if (threads == 0 || threads > MAXIMUM_WAIT_OBJECTS)
+	{
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	// Heap blocks are MEMORY_ALLOCATION_ALIGNMENT aligned as SList entries require.
+	m_items = HeapAlloc(GetProcessHeap(), 0, sizeof(VerifyItem) * bufferCount);
+	if ((VerifyItem*)m_items == NULL)
+		return FALSE;
+	m_hPending = CreateSemaphore(NULL, 0, bufferCount + threads, NULL);
+	if (m_hPending.IsInvalid())
+		return FALSE;
+	m_hFreed = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (m_hFreed.IsInvalid())
+		return FALSE;
+
+	m_pBuffers = (PBYTE)buffers;
+	m_dwBlockSize = blockSize;
+	m_pStatus = status;
+	m_lWorkers = STAT_LOOP_WORKER;
+	for (DWORD i = 0; i < threads; ++i)
+	{
+		HANDLE hThread = CreateThread(NULL, 0, VerifierThread, this, 0, NULL);
+		if (hThread == NULL)
+			return FALSE;
+		m_hThreads[m_dwThreads++] = hThread;
+	}
+	return TRUE;
+}
+
+BOOL CVerifierPool::IsRunning() const
+{
+	return m_dwThreads != 0;
+}
+
+BOOL CVerifierPool::Failed() const
+{
+	return m_lFailed;
+}
+
+void CVerifierPool::Submit(DWORD bufferIndex, const LARGE_INTEGER* pliOffset)
+{
+	VerifyItem* item = (VerifyItem*)m_items + bufferIndex;
+	item->BufferIndex = bufferIndex;
+	item->Offset = *pliOffset;
+
+	// Only the completion loop submits, so the peak needs no compare and swap.
+	LONGLONG backlog = InterlockedIncrement64((volatile LONGLONG*)&m_pStatus->VerifyBacklog);
+	if ((ULONGLONG)backlog > m_pStatus->VerifyBacklogPeak)
+		InterlockedExchange64((volatile LONGLONG*)&m_pStatus->VerifyBacklogPeak, backlog);
+
+	InterlockedPushEntrySList(&m_pending, &item->Entry);
+	ReleaseSemaphore(m_hPending, 1, NULL);
+}
+
+// Moves every verified buffer back to the caller's free buffers.
+void CVerifierPool::Reclaim(std::stack<DWORD>& freeBuffers)
+{
+	PSLIST_ENTRY entry = InterlockedFlushSList(&m_free);
+	while (entry != NULL)
+	{
+		VerifyItem* item = (VerifyItem*)entry;
+		entry = entry->Next;
+		freeBuffers.push(item->BufferIndex);
+	}
+}
+
+void CVerifierPool::WaitForFreeBuffer()
+{
+	if (QueryDepthSList(&m_free) == 0)
+		WaitForSingleObject(m_hFreed, INFINITE);
+}
+
+// Waits for the buffers already submitted to be verified and stops the threads. Fails with 
+// ERROR_CRC if any buffer did not verify.
+BOOL CVerifierPool::Finish()
+{
+	Stop();
+	if (m_lFailed)
+	{
+		SetLastError(ERROR_CRC);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+// Each thread exits when it is woken with nothing left to pop. Releasing the semaphore once 
+// per thread after the last submit lets the threads drain the queue first.
+void CVerifierPool::Stop()
+{
+	if (m_dwThreads == 0)
+		return;
+
+	ReleaseSemaphore(m_hPending, m_dwThreads, NULL);
+	WaitForMultipleObjects(m_dwThreads, m_hThreads, TRUE, INFINITE);
+	for (DWORD i = 0; i < m_dwThreads; ++i)
+	{
+		AddThreadCpuUsage(m_hThreads[i], &m_pStatus->VerifierCpu);
+		CloseHandle(m_hThreads[i]);
+	}
+	m_dwThreads = 0;
+}
+
+DWORD WINAPI CVerifierPool::VerifierThread(LPVOID param)
+{
+	CVerifierPool* pool = (CVerifierPool*)param;
+	Status* status = pool->m_pStatus;
+	CStatWriter stats(status, (DWORD)InterlockedIncrement(&pool->m_lWorkers));
+	LARGE_INTEGER liStart;
+	LARGE_INTEGER liEnd;
+
+	for (;;)
+	{
+		WaitForSingleObject(pool->m_hPending, INFINITE);
+		VerifyItem* item = (VerifyItem*)InterlockedPopEntrySList(&pool->m_pending);
+		if (item == NULL)
+			return 0;
+
+		PVOID buffer = pool->m_pBuffers + (SIZE_T)item->BufferIndex * pool->m_dwBlockSize;
+		QueryPerformanceCounter(&liStart);
+		if (!CDataPattern::Verify(buffer, pool->m_dwBlockSize, &item->Offset))
+			InterlockedExchange(&pool->m_lFailed, TRUE);
+		QueryPerformanceCounter(&liEnd);
+
+		stats->VerifyPerfCounts += liEnd.QuadPart - liStart.QuadPart;
+		stats->VerifiedBytes += pool->m_dwBlockSize;
+		stats.Publish();
+		InterlockedDecrement64((volatile LONGLONG*)&status->VerifyBacklog);
+		InterlockedPushEntrySList(&pool->m_free, &item->Entry);
+		SetEvent(pool->m_hFreed);
+	}
+}
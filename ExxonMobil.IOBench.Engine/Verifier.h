@@ -0,0 +1,64 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include <stack>
+#include "ResourceHelper.h"
+
+struct Status;
+
+// A read buffer on its way to a verifier thread and back. Entry must come first so the item 
+// can be pushed on an SList directly.
+struct VerifyItem
+{
+	SLIST_ENTRY Entry;
+	DWORD BufferIndex;
+	LARGE_INTEGER Offset;
+};
+
+// Verifies read buffers on a pool of threads so the completion loop can resubmit without 
+// waiting on verification. Buffers are handed over and returned through lock-free SLists.
+class CVerifierPool
+{
+public:
+	CVerifierPool();
+	~CVerifierPool();
+
+	BOOL Start(DWORD threads, PVOID buffers, DWORD bufferCount, DWORD blockSize, Status* status);
+	BOOL IsRunning() const;
+	BOOL Failed() const;
+
+	void Submit(DWORD bufferIndex, const LARGE_INTEGER* pliOffset);
+	void Reclaim(std::stack<DWORD>& freeBuffers);
+	void WaitForFreeBuffer();
+	BOOL Finish();
+
+private:
+	static DWORD WINAPI VerifierThread(LPVOID param);
+	void Stop();
+
+	SLIST_HEADER m_pending;
+	SLIST_HEADER m_free;
+	CEnsureHeapFree<VerifyItem*> m_items;
+	CEnsureCloseHandle m_hPending;
+	CEnsureCloseHandle m_hFreed;
+	HANDLE m_hThreads[MAXIMUM_WAIT_OBJECTS];
+	DWORD m_dwThreads;
+	PBYTE m_pBuffers;
+	DWORD m_dwBlockSize;
+	Status* m_pStatus;
+	volatile LONG m_lWorkers;
+	volatile LONG m_lFailed;
+};
@@ -0,0 +1,30 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "WorkloadSpec.h"
+
+WorkloadSpec::WorkloadSpec() :
+	Operation(BENCHOP_READ),
+	AccessPattern(BENCHAP_SEQUENTIAL),
+	Blocks(0),
+	BlockSize(64 * 1024),
+	QueueDepth(1),
+	Synchronous(FALSE),
+	Verify(FALSE),
+	RandomData(FALSE),
+	Seed(0),
+	ProgressBlocks(0)
+{
+	ZeroMemory(&Options, sizeof(Options));
+	Options.NumaNode = NUMA_NO_PREFERRED_NODE;
+}
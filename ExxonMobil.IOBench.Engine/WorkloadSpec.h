@@ -0,0 +1,36 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include "OpOptions.h"
+
+// Everything a BenchmarkEngine needs to run one pass over a target. AsynchronousOp and 
+// SynchronousOp fill one from their arguments; callers that link the engine fill it directly.
+struct WorkloadSpec
+{
+	WorkloadSpec();
+
+	DWORD Operation;           // BENCHOP_*
+	DWORD AccessPattern;       // BENCHAP_SEQUENTIAL or BENCHAP_RANDOM
+	ULONGLONG Blocks;          // from 4 to 2^36 for random access, which covers the largest power of 2 below it
+	DWORD BlockSize;           // a multiple of the sector size for unbuffered handles
+	DWORD QueueDepth;          // requests kept in flight by the asynchronous loop
+	BOOL Synchronous;          // one request at a time on a handle opened without FILE_FLAG_OVERLAPPED
+	BOOL Verify;               // check reads against the offset pattern
+	BOOL RandomData;           // write random data instead of the offset pattern
+	ULONGLONG Seed;            // random data seed, 0 to seed from the clock
+	ULONGLONG ProgressBlocks;  // completions between progress callbacks, 0 for none
+	OpOptions Options;         // tuning, placement and target device, all off when zeroed
+};
@@ -0,0 +1,236 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "MicroBench.h"
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+volatile ULONGLONG g_microBenchSink;
+
+struct MicroBenchResult
+{
+	std::wstring Name;
+	DWORD Arg;
+	ULONGLONG Iterations;
+	double NanosecondsPerOp;
+	double BytesPerSec;
+	double OpsPerSec;
+};
+
+static const DWORD Repetitions = 3;
+
+static BOOL TimeRun(const MicroBenchCase& benchCase, MicroBenchState& state, LONGLONG frequency, double* seconds)
+{
+	LARGE_INTEGER liStart, liEnd;
+	QueryPerformanceCounter(&liStart);
+	BOOL bOk = benchCase.Routine(state);
+	QueryPerformanceCounter(&liEnd);
+	*seconds = (double)(liEnd.QuadPart - liStart.QuadPart) / frequency;
+	return bOk;
+}
+
+// Grows the iteration count until a run takes at least minSeconds, then keeps the fastest of 
+// Repetitions runs at that count. The fastest run is the one least disturbed by the system.
+static BOOL Measure(const MicroBenchCase& benchCase, DWORD arg, double minSeconds, MicroBenchResult* result)
+{
+	LARGE_INTEGER liFrequency;
+	QueryPerformanceFrequency(&liFrequency);
+
+	MicroBenchState state = { 1, arg, 0 };
+	double seconds;
+	for (;;)
+	{
+		if (!TimeRun(benchCase, state, liFrequency.QuadPart, &seconds))
+			return FALSE;
+		if (seconds >= minSeconds)
+			break;
+
+		// Aim a little past the target, growing between 2x and 10x per step.
+		double scale = seconds > 0 ? minSeconds * 1.2 / seconds : 10;
+		if (scale < 2)
+			scale = 2;
+		else if (scale > 10)
+			scale = 10;
+		state.Iterations = (ULONGLONG)(state.Iterations * scale);
+	}
+
+	double best = seconds;
+	for (DWORD i = 1; i < Repetitions; ++i)
+	{
+		if (!TimeRun(benchCase, state, liFrequency.QuadPart, &seconds))
+			return FALSE;
+		if (seconds < best)
+			best = seconds;
+	}
+
+	result->Name = benchCase.Name;
+	result->Arg = arg;
+	result->Iterations = state.Iterations;
+	result->NanosecondsPerOp = best * 1e9 / state.Iterations;
+	result->OpsPerSec = state.Iterations / best;
+	result->BytesPerSec = result->OpsPerSec * state.BytesPerIteration;
+	return TRUE;
+}
+
+static std::wstring ResultKey(const std::wstring& name, DWORD arg)
+{
+	wchar_t szArg[16];
+	swprintf_s(szArg, L"/%u", arg);
+	return name + szArg;
+}
+
+// Reads ns/op from the most recent rows of a results file that were written under another tag.
+static BOOL LoadBaseline(LPCWSTR path, const std::wstring& tag, std::map<std::wstring, double>& baseline)
+{
+	FILE* file;
+	if (_wfopen_s(&file, path, L"r") != 0)
+		return FALSE;
+
+	wchar_t line[1024];
+	fgetws(line, _countof(line), file); // header
+	while (fgetws(line, _countof(line), file))
+	{
+		// Timestamp, Tag, Benchmark, Arg, Iterations, ns/op, ...
+		std::vector<std::wstring> fields;
+		wchar_t* context = NULL;
+		for (wchar_t* field = wcstok_s(line, L"\t\r\n", &context); field; field = wcstok_s(NULL, L"\t\r\n", &context))
+			fields.push_back(field);
+		if (fields.size() < 6 || fields[1] == tag)
+			continue;
+		baseline[ResultKey(fields[2], wcstoul(fields[3].c_str(), NULL, 10))] = wcstod(fields[5].c_str(), NULL);
+	}
+
+	fclose(file);
+	return TRUE;
+}
+
+static BOOL AppendResults(LPCWSTR path, const std::wstring& tag, const std::vector<MicroBenchResult>& results)
+{
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	BOOL writeHeader = !GetFileAttributesEx(path, GetFileExInfoStandard, &attributes) || 
+		(attributes.nFileSizeLow == 0 && attributes.nFileSizeHigh == 0);
+
+	FILE* file;
+	if (_wfopen_s(&file, path, L"a") != 0)
+		return FALSE;
+
+	SYSTEMTIME now;
+	GetLocalTime(&now);
+	if (writeHeader)
+		fwprintf(file, L"Timestamp\tTag\tBenchmark\tArg\tIterations\tns/op\tMB/s\tOps/s\n");
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const MicroBenchResult& result = results[i];
+		fwprintf(file, L"%04u-%02u-%02u %02u:%02u:%02u\t%s\t%s\t%u\t%llu\t%.2f\t%.1f\t%.0f\n",
+			now.wYear, now.wMonth, now.wDay, now.wHour, now.wMinute, now.wSecond, 
+			tag.c_str(), result.Name.c_str(), result.Arg, result.Iterations, 
+			result.NanosecondsPerOp, result.BytesPerSec / (1024 * 1024), result.OpsPerSec);
+	}
+
+	fclose(file);
+	return TRUE;
+}
+
+static void PrintUsage()
+{
+	wprintf(
+		L"Usage: IOBench.MicroBench [options]\n"
+		L"\n"
+		L" -filter=X   Run only the cases whose name contains X.\n"
+		L" -min=#      Minimum milliseconds per timed run (default: 500).\n"
+		L" -rf=X       File to append results to in TSV format.\n"
+		L" -tag=X      Identifier for the result rows, e.g. a commit hash.\n"
+		L" -compare=X  Compare with the latest rows of results file X that have a\n"
+		L"             different tag. Change is in ns/op, so positive is slower.\n");
+}
+
+int wmain(int argc, wchar_t* argv[])
+{
+	std::wstring filter, resultPath, comparePath, tag(L"-");
+	double minSeconds = 0.5;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::wstring arg = argv[i];
+		std::wstring value = arg.find(L'=') == std::wstring::npos ? L"" : arg.substr(arg.find(L'=') + 1);
+		if (arg.compare(0, 8, L"-filter=") == 0)
+			filter = value;
+		else if (arg.compare(0, 5, L"-min=") == 0 && _wtoi(value.c_str()) > 0)
+			minSeconds = _wtoi(value.c_str()) / 1000.0;
+		else if (arg.compare(0, 4, L"-rf=") == 0)
+			resultPath = value;
+		else if (arg.compare(0, 5, L"-tag=") == 0 && !value.empty())
+			tag = value;
+		else if (arg.compare(0, 9, L"-compare=") == 0)
+			comparePath = value;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	std::map<std::wstring, double> baseline;
+	if (!comparePath.empty() && !LoadBaseline(comparePath.c_str(), tag, baseline))
+	{
+		fwprintf(stderr, L"Failed to read %s.\n", comparePath.c_str());
+		return 1;
+	}
+
+	// One thread at raised priority on a fixed processor keeps the timings repeatable.
+	SetThreadAffinityMask(GetCurrentThread(), 1);
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+
+	DWORD caseCount;
+	const MicroBenchCase* cases = GetMicroBenchCases(&caseCount);
+	std::vector<MicroBenchResult> results;
+
+	wprintf(L"%-28s %8s %12s %12s %10s %14s %8s\n", L"Benchmark", L"Arg", L"Iterations", L"ns/op", L"MB/s", L"Ops/s", L"Change");
+	for (DWORD c = 0; c < caseCount; ++c)
+	{
+		if (!filter.empty() && std::wstring(cases[c].Name).find(filter) == std::wstring::npos)
+			continue;
+
+		DWORD argCount = cases[c].Args ? cases[c].ArgCount : 1;
+		for (DWORD a = 0; a < argCount; ++a)
+		{
+			MicroBenchResult result;
+			DWORD arg = cases[c].Args ? cases[c].Args[a] : 0;
+			if (!Measure(cases[c], arg, minSeconds, &result))
+			{
+				fwprintf(stderr, L"%s/%u failed (error %u).\n", cases[c].Name, arg, GetLastError());
+				return 1;
+			}
+			results.push_back(result);
+
+			wchar_t szChange[16] = L"";
+			std::map<std::wstring, double>::const_iterator base = baseline.find(ResultKey(result.Name, arg));
+			if (base != baseline.end() && base->second > 0)
+				swprintf_s(szChange, L"%+.1f%%", (result.NanosecondsPerOp / base->second - 1) * 100);
+
+			wprintf(L"%-28s %8u %12llu %12.2f %10.1f %14.0f %8s\n", result.Name.c_str(), arg, result.Iterations, 
+				result.NanosecondsPerOp, result.BytesPerSec / (1024 * 1024), result.OpsPerSec, szChange);
+		}
+	}
+
+	if (!resultPath.empty() && !AppendResults(resultPath.c_str(), tag, results))
+	{
+		fwprintf(stderr, L"Failed to write %s.\n", resultPath.c_str());
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,40 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+
+// Google Benchmark style harness for the native hot paths. A routine runs its operation 
+// Iterations times; the runner grows the count until a run is long enough to time reliably.
+struct MicroBenchState
+{
+	ULONGLONG Iterations;
+	DWORD Arg;                   // block size, queue depth, ... as listed for the case
+	ULONGLONG BytesPerIteration; // set by the routine to report throughput, 0 for none
+};
+
+typedef BOOL (*PMICROBENCH_ROUTINE)(MicroBenchState& state);
+
+struct MicroBenchCase
+{
+	LPCWSTR Name;
+	PMICROBENCH_ROUTINE Routine;
+	const DWORD* Args;  // one run per argument, or NULL for a single run with Arg 0
+	DWORD ArgCount;
+};
+
+const MicroBenchCase* GetMicroBenchCases(PDWORD count);
+
+// Routines fold their results into the sink so the compiler cannot drop the work.
+extern volatile ULONGLONG g_microBenchSink;
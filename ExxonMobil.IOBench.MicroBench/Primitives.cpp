@@ -0,0 +1,151 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "MicroBench.h"
+#include "FiboLfsr.h"
+#include "DataPattern.h"
+#include "LatencyHistogram.h"
+#include "ResourceHelper.h"
+#include "NativeCore.h"
+#include "OpOptions.h"
+#include "Status.h"
+
+#define ARRAYCOUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static const DWORD BlockSizes[] = { 512, 4096, 65536, 1048576 };
+static const DWORD QueueDepths[] = { 1, 8, 32, 128 };
+
+// Allocates a page aligned buffer of state.Arg bytes, as the transfer loops do.
+class CBenchBuffer
+{
+public:
+	CBenchBuffer(DWORD size) : m_erp(VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE)) { }
+	operator PVOID() { return m_erp; }
+
+private:
+	CEnsureReleaseRegion m_erp;
+};
+
+static BOOL LfsrNext(MicroBenchState& state)
+{
+	FiboLfsr lfsr(36);
+	ULONGLONG sum = 0;
+	for (ULONGLONG i = 0; i < state.Iterations; ++i)
+		sum += lfsr.Next();
+	g_microBenchSink += sum;
+	return TRUE;
+}
+
+static BOOL LatencyRecord(MicroBenchState& state)
+{
+	LatencyHistogram histogram;
+	ZeroMemory(&histogram, sizeof(histogram));
+	for (ULONGLONG i = 0; i < state.Iterations; ++i)
+		RecordLatency(&histogram, i & 0xFFFF);
+	g_microBenchSink += histogram.Buckets[1];
+	return TRUE;
+}
+
+static BOOL FillPattern(MicroBenchState& state)
+{
+	CBenchBuffer buffer(state.Arg);
+	if ((PVOID)buffer == NULL)
+		return FALSE;
+
+	LARGE_INTEGER liOffset = { 0 };
+	for (ULONGLONG i = 0; i < state.Iterations; ++i, liOffset.QuadPart += state.Arg)
+		CDataPattern::Fill(buffer, state.Arg, &liOffset);
+	g_microBenchSink += *(PULONGLONG)(PVOID)buffer;
+	state.BytesPerIteration = state.Arg;
+	return TRUE;
+}
+
+static BOOL FillRandom(MicroBenchState& state)
+{
+	CBenchBuffer buffer(state.Arg);
+	if ((PVOID)buffer == NULL)
+		return FALSE;
+
+	CDataPattern pattern;
+	pattern.Seed(0xBEEF);
+	LARGE_INTEGER liOffset = { 0 };
+	for (ULONGLONG i = 0; i < state.Iterations; ++i)
+		pattern.Fill(buffer, state.Arg, &liOffset, TRUE);
+	g_microBenchSink += *(PULONGLONG)(PVOID)buffer;
+	state.BytesPerIteration = state.Arg;
+	return TRUE;
+}
+
+static BOOL VerifyPattern(MicroBenchState& state)
+{
+	CBenchBuffer buffer(state.Arg);
+	if ((PVOID)buffer == NULL)
+		return FALSE;
+
+	LARGE_INTEGER liOffset = { 0 };
+	CDataPattern::Fill(buffer, state.Arg, &liOffset);
+	ULONGLONG verified = 0;
+	for (ULONGLONG i = 0; i < state.Iterations; ++i)
+		verified += CDataPattern::Verify(buffer, state.Arg, &liOffset);
+	g_microBenchSink += verified;
+	state.BytesPerIteration = state.Arg;
+	return verified == state.Iterations;
+}
+
+// AsynchronousOp itself against the emulated null device, which completes every request as 
+// soon as it is reaped. One iteration is one request, so ops/s is the most IOPS the 
+// production submit/reap loop can drive.
+static BOOL RunNullLoop(MicroBenchState& state, DWORD op, DWORD blockSize, DWORD queueDepth)
+{
+	CEnsureHeapFree<Status*> cefStatus = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(Status));
+	if ((Status*)cefStatus == NULL)
+		return FALSE;
+
+	OpOptions options;
+	ZeroMemory(&options, sizeof(options));
+	options.SubmitBatch = 1;
+	options.NumaNode = NUMA_NO_PREFERRED_NODE;
+	options.Device.Type = EMULATED_NULL;
+	if (!AsynchronousOp(INVALID_HANDLE_VALUE, op, BENCHAP_SEQUENTIAL, FALSE, state.Iterations, blockSize, FALSE, queueDepth, &options, cefStatus))
+		return FALSE;
+
+	g_microBenchSink += ((Status*)cefStatus)->Workers[STAT_LOOP_WORKER].Counters.BlocksTransferred;
+	state.BytesPerIteration = blockSize;
+	return TRUE;
+}
+
+static BOOL AsyncNullRead(MicroBenchState& state)
+{
+	return RunNullLoop(state, BENCHOP_READ, 4096, state.Arg);
+}
+
+static BOOL AsyncNullWrite(MicroBenchState& state)
+{
+	return RunNullLoop(state, BENCHOP_WRITE, state.Arg, 32);
+}
+
+static const MicroBenchCase Cases[] = {
+	{ L"FiboLfsr.Next", LfsrNext, NULL, 0 },
+	{ L"LatencyHistogram.Record", LatencyRecord, NULL, 0 },
+	{ L"DataPattern.Fill/bs", FillPattern, BlockSizes, ARRAYCOUNT(BlockSizes) },
+	{ L"DataPattern.FillRandom/bs", FillRandom, BlockSizes, ARRAYCOUNT(BlockSizes) },
+	{ L"DataPattern.Verify/bs", VerifyPattern, BlockSizes, ARRAYCOUNT(BlockSizes) },
+	{ L"AsyncOp.NullRead4K/qd", AsyncNullRead, QueueDepths, ARRAYCOUNT(QueueDepths) },
+	{ L"AsyncOp.NullWriteQD32/bs", AsyncNullWrite, BlockSizes, ARRAYCOUNT(BlockSizes) },
+};
+
+const MicroBenchCase* GetMicroBenchCases(PDWORD count)
+{
+	*count = ARRAYCOUNT(Cases);
+	return Cases;
+}
@@ -0,0 +1,158 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "stdafx.h"
+#include "NativeCore.h"
+#include "ResourceHelper.h"
+#include "CpuUsage.h"
+
+#include <winternl.h>
+
+#define STATUS_INFO_LENGTH_MISMATCH ((NTSTATUS)0xC0000004L)
+#define SystemProcessInformationClass 5
+
+// Full layouts of the structures returned by NtQuerySystemInformation(SystemProcessInformation).
+// winternl.h only documents a subset of the fields and does not include the thread array.
+struct NtSystemThreadInformation
+{
+	LARGE_INTEGER KernelTime;
+	LARGE_INTEGER UserTime;
+	LARGE_INTEGER CreateTime;
+	ULONG WaitTime;
+	PVOID StartAddress;
+	HANDLE UniqueProcess;
+	HANDLE UniqueThread;
+	LONG Priority;
+	LONG BasePriority;
+	ULONG ContextSwitches;
+	ULONG ThreadState;
+	ULONG WaitReason;
+};
+
+struct NtSystemProcessInformation
+{
+	ULONG NextEntryOffset;
+	ULONG NumberOfThreads;
+	LARGE_INTEGER WorkingSetPrivateSize;
+	ULONG HardFaultCount;
+	ULONG NumberOfThreadsHighWatermark;
+	ULONGLONG CycleTime;
+	LARGE_INTEGER CreateTime;
+	LARGE_INTEGER UserTime;
+	LARGE_INTEGER KernelTime;
+	UNICODE_STRING ImageName;
+	LONG BasePriority;
+	HANDLE UniqueProcessId;
+	HANDLE InheritedFromUniqueProcessId;
+	ULONG HandleCount;
+	ULONG SessionId;
+	ULONG_PTR UniqueProcessKey;
+	SIZE_T PeakVirtualSize;
+	SIZE_T VirtualSize;
+	ULONG PageFaultCount;
+	SIZE_T PeakWorkingSetSize;
+	SIZE_T WorkingSetSize;
+	SIZE_T QuotaPeakPagedPoolUsage;
+	SIZE_T QuotaPagedPoolUsage;
+	SIZE_T QuotaPeakNonPagedPoolUsage;
+	SIZE_T QuotaNonPagedPoolUsage;
+	SIZE_T PagefileUsage;
+	SIZE_T PeakPagefileUsage;
+	SIZE_T PrivatePageCount;
+	LARGE_INTEGER ReadOperationCount;
+	LARGE_INTEGER WriteOperationCount;
+	LARGE_INTEGER OtherOperationCount;
+	LARGE_INTEGER ReadTransferCount;
+	LARGE_INTEGER WriteTransferCount;
+	LARGE_INTEGER OtherTransferCount;
+	NtSystemThreadInformation Threads[1];
+};
+
+typedef NTSTATUS (NTAPI *NtQuerySystemInformationPtr)
+	(
+	IN ULONG SystemInformationClass,
+	OUT PVOID SystemInformation,
+	IN ULONG SystemInformationLength,
+	OUT PULONG ReturnLength OPTIONAL
+	);
+
+BOOL GetThreadCpuUsage(CpuUsage* usage)
+{
+	FILETIME ftCreation, ftExit, ftKernel, ftUser;
+	if (!GetThreadTimes(GetCurrentThread(), &ftCreation, &ftExit, &ftKernel, &ftUser))
+		return FALSE;
+	usage->UserTime = ((ULONGLONG)ftUser.dwHighDateTime << 32) | ftUser.dwLowDateTime;
+	usage->KernelTime = ((ULONGLONG)ftKernel.dwHighDateTime << 32) | ftKernel.dwLowDateTime;
+
+	return QueryThreadCycleTime(GetCurrentThread(), &usage->Cycles);
+}
+
+// Context switches are only exposed through the system process list, which is expensive 
+// to query. Callers should take this sample outside of the interval being measured.
+BOOL GetThreadContextSwitches(PULONGLONG contextSwitches)
+{
+	DWORD processId = GetCurrentProcessId();
+	DWORD threadId = GetCurrentThreadId();
+
+	NtQuerySystemInformationPtr pNtQuerySystemInformation = (NtQuerySystemInformationPtr)GetProcAddress(GetModuleHandle(L"ntdll.dll"), "NtQuerySystemInformation");
+	if (pNtQuerySystemInformation == NULL)
+		return FALSE;
+
+	// The process list is a snapshot of the whole system. Grow the buffer until it fits.
+	ULONG bufferSize = 256 * 1024;
+	CEnsureHeapFree<PBYTE> cefBuffer;
+	NTSTATUS ntStatus;
+	do
+	{
+		cefBuffer = HeapAlloc(GetProcessHeap(), 0, bufferSize);
+		if ((PBYTE)cefBuffer == NULL)
+		{
+			SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+			return FALSE;
+		}
+		ULONG returnLength = 0;
+		ntStatus = pNtQuerySystemInformation(SystemProcessInformationClass, cefBuffer, bufferSize, &returnLength);
+		if (ntStatus == STATUS_INFO_LENGTH_MISMATCH)
+			bufferSize = returnLength > bufferSize * 2 ? returnLength : bufferSize * 2;
+	} while (ntStatus == STATUS_INFO_LENGTH_MISMATCH);
+
+	if (!NT_SUCCESS(ntStatus))
+	{
+		SetLastError(HRESULT_FROM_NT(ntStatus));
+		return FALSE;
+	}
+
+	PBYTE pEntry = cefBuffer;
+	for (;;)
+	{
+		NtSystemProcessInformation* process = (NtSystemProcessInformation*)pEntry;
+		if ((ULONG_PTR)process->UniqueProcessId == processId)
+		{
+			for (ULONG i = 0; i < process->NumberOfThreads; ++i)
+			{
+				if ((ULONG_PTR)process->Threads[i].UniqueThread == threadId)
+				{
+					*contextSwitches = process->Threads[i].ContextSwitches;
+					return TRUE;
+				}
+			}
+			break;
+		}
+		if (process->NextEntryOffset == 0)
+			break;
+		pEntry += process->NextEntryOffset;
+	}
+
+	SetLastError(ERROR_NOT_FOUND);
+	return FALSE;
+}
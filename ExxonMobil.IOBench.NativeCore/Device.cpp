@@ -0,0 +1,200 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "stdafx.h"
+#include "NativeCore.h"
+#include "ResourceHelper.h"
+#include "Device.h"
+
+#include <winioctl.h>
+
+// Enough for a default GPT partition array.
+#define MAX_LAYOUT_PARTITIONS 128
+
+// Not defined by older SDK headers.
+#define StorageDeviceNumaPropertyId 59
+#define STORAGE_DEVICE_NUMA_NODE_UNKNOWN MAXDWORD
+
+struct StorageDeviceNumaProperty
+{
+	DWORD Version;
+	DWORD Size;
+	DWORD NumaNode;
+};
+
+static BOOL QueryProperty(HANDLE hDevice, STORAGE_PROPERTY_ID propertyId, PVOID buffer, DWORD size, PDWORD bytesReturned)
+{
+	STORAGE_PROPERTY_QUERY query;
+	ZeroMemory(&query, sizeof(query));
+	query.PropertyId = propertyId;
+	query.QueryType = PropertyStandardQuery;
+
+	ZeroMemory(buffer, size);
+	return DeviceIoControl(hDevice, IOCTL_STORAGE_QUERY_PROPERTY, &query, sizeof(query), buffer, size, bytesReturned, NULL);
+}
+
+// Copies an ASCII identifier out of a storage descriptor, dropping the padding drives report.
+static void CopyDescriptorString(const BYTE* descriptor, DWORD length, DWORD offset, LPWSTR target, DWORD chars)
+{
+	target[0] = L'\0';
+	if (offset == 0 || offset >= length)
+		return;
+
+	DWORD count = 0;
+	for (DWORD i = offset; i < length && descriptor[i] != 0 && count < chars - 1; i++)
+	{
+		if (descriptor[i] == ' ' && (count == 0 || target[count - 1] == L' '))
+			continue;
+		target[count++] = (WCHAR)descriptor[i];
+	}
+	while (count > 0 && target[count - 1] == L' ')
+		count--;
+	target[count] = L'\0';
+}
+
+static BOOL CountPartitions(HANDLE hDevice, PDWORD partitions)
+{
+	DWORD size = sizeof(DRIVE_LAYOUT_INFORMATION_EX) + MAX_LAYOUT_PARTITIONS * sizeof(PARTITION_INFORMATION_EX);
+	CEnsureHeapFree<DRIVE_LAYOUT_INFORMATION_EX*> cefLayout = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, size);
+	DRIVE_LAYOUT_INFORMATION_EX* layout = cefLayout;
+	if (layout == NULL)
+	{
+		SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+		return FALSE;
+	}
+
+	DWORD bytesReturned;
+	if (!DeviceIoControl(hDevice, IOCTL_DISK_GET_DRIVE_LAYOUT_EX, NULL, 0, layout, size, &bytesReturned, NULL))
+		return FALSE;
+
+	// MBR disks always report four slots, and a GPT array has empty entries.
+	static const GUID unusedType = { 0 };
+	DWORD count = 0;
+	for (DWORD i = 0; i < layout->PartitionCount; i++)
+	{
+		const PARTITION_INFORMATION_EX& partition = layout->PartitionEntry[i];
+		if (partition.PartitionLength.QuadPart == 0)
+			continue;
+		if (partition.PartitionStyle == PARTITION_STYLE_MBR && partition.Mbr.PartitionType == PARTITION_ENTRY_UNUSED)
+			continue;
+		if (partition.PartitionStyle == PARTITION_STYLE_GPT && IsEqualGUID(partition.Gpt.PartitionType, unusedType))
+			continue;
+		count++;
+	}
+
+	*partitions = count;
+	return TRUE;
+}
+
+// Describes a raw disk such as \\.\PhysicalDrive1. Size, sector sizes and the partition count
+// are required; the adapter, identity and seek penalty queries are best effort because not 
+// every miniport answers them.
+BOOL GetDeviceInfo(LPCWSTR path, DeviceInfo* info)
+{
+	ZeroMemory(info, sizeof(DeviceInfo));
+
+	CEnsureCloseFile hDevice = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
+	if (hDevice.IsInvalid())
+		return FALSE;
+
+	DWORD bytesReturned;
+	GET_LENGTH_INFORMATION length;
+	if (!DeviceIoControl(hDevice, IOCTL_DISK_GET_LENGTH_INFO, NULL, 0, &length, sizeof(length), &bytesReturned, NULL))
+		return FALSE;
+	info->SizeBytes = length.Length.QuadPart;
+
+	STORAGE_ACCESS_ALIGNMENT_DESCRIPTOR alignment;
+	if (QueryProperty(hDevice, StorageAccessAlignmentProperty, &alignment, sizeof(alignment), &bytesReturned) && bytesReturned >= sizeof(alignment))
+	{
+		info->LogicalSectorBytes = alignment.BytesPerLogicalSector;
+		info->PhysicalSectorBytes = alignment.BytesPerPhysicalSector;
+		info->AlignmentOffsetBytes = alignment.BytesOffsetForSectorAlignment;
+	}
+	else
+	{
+		// Drivers that predate the alignment property only know the logical sector size.
+		DISK_GEOMETRY_EX geometry;
+		if (!DeviceIoControl(hDevice, IOCTL_DISK_GET_DRIVE_GEOMETRY_EX, NULL, 0, &geometry, sizeof(geometry), &bytesReturned, NULL))
+			return FALSE;
+		info->LogicalSectorBytes = geometry.Geometry.BytesPerSector;
+		info->PhysicalSectorBytes = geometry.Geometry.BytesPerSector;
+	}
+
+	if (!CountPartitions(hDevice, &info->Partitions))
+		return FALSE;
+
+	STORAGE_ADAPTER_DESCRIPTOR adapter;
+	if (QueryProperty(hDevice, StorageAdapterProperty, &adapter, sizeof(adapter), &bytesReturned) && bytesReturned >= sizeof(adapter))
+		info->MaxTransferBytes = adapter.MaximumTransferLength;
+
+	BYTE descriptor[1024];
+	if (QueryProperty(hDevice, StorageDeviceProperty, descriptor, sizeof(descriptor), &bytesReturned) && bytesReturned >= sizeof(STORAGE_DEVICE_DESCRIPTOR))
+	{
+		const STORAGE_DEVICE_DESCRIPTOR* device = (const STORAGE_DEVICE_DESCRIPTOR*)descriptor;
+		info->BusType = device->BusType;
+		info->CommandQueueing = device->CommandQueueing;
+		info->Removable = device->RemovableMedia;
+		CopyDescriptorString(descriptor, bytesReturned, device->ProductIdOffset, info->Model, DEVICE_MODEL_CHARS);
+		CopyDescriptorString(descriptor, bytesReturned, device->SerialNumberOffset, info->SerialNumber, DEVICE_SERIAL_CHARS);
+	}
+
+	DEVICE_SEEK_PENALTY_DESCRIPTOR seekPenalty;
+	if (QueryProperty(hDevice, StorageDeviceSeekPenaltyProperty, &seekPenalty, sizeof(seekPenalty), &bytesReturned) && bytesReturned >= sizeof(seekPenalty))
+	{
+		info->SeekPenaltyKnown = TRUE;
+		info->SeekPenalty = seekPenalty.IncursSeekPenalty;
+	}
+
+	return TRUE;
+}
+
+// Resolves the volume holding the path and asks the storage stack which NUMA node the 
+// device is attached to. Requires Windows 10; older systems fail the query.
+BOOL GetDeviceNumaNode(LPCWSTR path, PDWORD numaNode)
+{
+	WCHAR volumePath[MAX_PATH];
+	WCHAR volumeName[MAX_PATH];
+	if (!GetVolumePathNameW(path, volumePath, MAX_PATH))
+		return FALSE;
+	if (!GetVolumeNameForVolumeMountPointW(volumePath, volumeName, MAX_PATH))
+		return FALSE;
+
+	// The volume device is opened without the trailing backslash.
+	size_t length = wcslen(volumeName);
+	if (length > 0 && volumeName[length - 1] == L'\\')
+		volumeName[length - 1] = L'\0';
+
+	CEnsureCloseFile hVolume = CreateFileW(volumeName, 0, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
+	if (hVolume.IsInvalid())
+		return FALSE;
+
+	STORAGE_PROPERTY_QUERY query;
+	ZeroMemory(&query, sizeof(query));
+	query.PropertyId = (STORAGE_PROPERTY_ID)StorageDeviceNumaPropertyId;
+	query.QueryType = PropertyStandardQuery;
+
+	StorageDeviceNumaProperty property;
+	ZeroMemory(&property, sizeof(property));
+	DWORD bytesReturned;
+	if (!DeviceIoControl(hVolume, IOCTL_STORAGE_QUERY_PROPERTY, &query, sizeof(query), &property, sizeof(property), &bytesReturned, NULL))
+		return FALSE;
+
+	if (bytesReturned < sizeof(property) || property.NumaNode == STORAGE_DEVICE_NUMA_NODE_UNKNOWN)
+	{
+		SetLastError(ERROR_NOT_FOUND);
+		return FALSE;
+	}
+
+	*numaNode = property.NumaNode;
+	return TRUE;
+}
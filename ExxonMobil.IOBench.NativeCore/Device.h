@@ -0,0 +1,37 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+
+#define DEVICE_MODEL_CHARS  64
+#define DEVICE_SERIAL_CHARS 64
+
+// Geometry and queueing of a raw disk. Layout is shared with the managed NativeDeviceInfo.
+struct DeviceInfo
+{
+	ULONGLONG SizeBytes;
+	DWORD LogicalSectorBytes;
+	DWORD PhysicalSectorBytes;
+	DWORD AlignmentOffsetBytes;    // offset of the first physical sector boundary from LBA 0
+	DWORD MaxTransferBytes;        // largest request the adapter accepts, 0 when unknown
+	DWORD BusType;                 // STORAGE_BUS_TYPE
+	BOOL CommandQueueing;
+	BOOL Removable;
+	BOOL SeekPenaltyKnown;
+	BOOL SeekPenalty;              // rotational media
+	DWORD Partitions;              // partitions in use, including ones without a volume
+	WCHAR Model[DEVICE_MODEL_CHARS];
+	WCHAR SerialNumber[DEVICE_SERIAL_CHARS];
+};
@@ -15,190 +15,169 @@
 #include "NativeCore.h"
 #include "ResourceHelper.h"
 #include "Status.h"
-#include "FiboLfsr.h"
+#include "StatWriter.h"
+#include "ReplayRecord.h"
+#include "OpOptions.h"
+#include "Placement.h"
+#include "PerfCount.h"
+#include "DataPattern.h"
+#include "IocpBackend.h"
+#include "WorkloadSpec.h"
+#include "BenchmarkEngine.h"
 
-#include <stdlib.h>
-#include <time.h>
-#include <crtdbg.h>
 #include <Windows.h>
 #include <stack>
 #include <winternl.h>
-#include <random>
+#include <winioctl.h>
 
-BOOL AsynchronousOp(HANDLE hFile, DWORD op, DWORD ap, BOOL verify, DWORD blocks, DWORD blockSize, BOOL randomData, DWORD maxOutstanding, Status* status)
+// The transfer loops live in the engine. These exports describe the workload to it from the 
+// managed side's arguments.
+BOOL AsynchronousOp(HANDLE hFile, DWORD op, DWORD ap, BOOL verify, ULONGLONG blocks, DWORD blockSize, BOOL randomData, DWORD maxOutstanding, const OpOptions* options, Status* status)
+{
+	WorkloadSpec spec;
+	spec.Operation = op;
+	spec.AccessPattern = ap;
+	spec.Verify = verify;
+	spec.Blocks = blocks;
+	spec.BlockSize = blockSize;
+	spec.RandomData = randomData;
+	spec.QueueDepth = maxOutstanding;
+	spec.Options = *options;
+	BenchmarkEngine engine(spec, status);
+	return engine.Run(hFile);
+}
+
+BOOL SynchronousOp(HANDLE hFile, DWORD op, DWORD ap, BOOL verify, ULONGLONG blocks, DWORD blockSize, BOOL randomData, const OpOptions* options, Status* status)
+{
+	WorkloadSpec spec;
+	spec.Operation = op;
+	spec.AccessPattern = ap;
+	spec.Verify = verify;
+	spec.Blocks = blocks;
+	spec.BlockSize = blockSize;
+	spec.RandomData = randomData;
+	spec.Synchronous = TRUE;
+	spec.Options = *options;
+	BenchmarkEngine engine(spec, status);
+	return engine.Run(hFile);
+}
+
+BOOL ReplayOp(HANDLE hFile, const ReplayRecord* records, DWORD recordCount, DWORD maxLength, BOOL timed, double timeScale, DWORD maxOutstanding, const OpOptions* options, Status* status)
 {
-	BOOL bOk;
-	LARGE_INTEGER liCurrentFileOffset = { 0 };
 	DWORD nTransfersInProgress = 0;
-	DWORD currentBlock = 0;
+	DWORD currentRecord = 0;
 	LARGE_INTEGER liPerfCount;
-	std::stack<BYTE> reqIdxStack;
-
-	CEnsureHeapFree<LPOVERLAPPED> cefOverlappeds = 
-		HeapAlloc(GetProcessHeap(), 0, sizeof(OVERLAPPED) * maxOutstanding);
-	CEnsureHeapFree<LPOVERLAPPED_ENTRY> cefOverlappedEntries = 
-		HeapAlloc(GetProcessHeap(), 0, sizeof(OVERLAPPED_ENTRY) * maxOutstanding);
-	CEnsureReleaseRegion erpBuffer = VirtualAlloc(NULL, blockSize * maxOutstanding, MEM_COMMIT, PAGE_READWRITE);
+	LARGE_INTEGER liFrequency;
+	LARGE_INTEGER liReplayStart;
+	std::stack<DWORD> reqIdxStack;
+	CStatWriter stats(status, STAT_LOOP_WORKER);
+
+	CEnsureHeapFree<IoRequest*> cefRequests = 
+		HeapAlloc(GetProcessHeap(), 0, sizeof(IoRequest) * maxOutstanding);
+	CEnsureHeapFree<IoRequest**> cefCompleted = 
+		HeapAlloc(GetProcessHeap(), 0, sizeof(IoRequest*) * maxOutstanding);
+	CThreadPlacement placement;
+	if (!placement.Apply(options))
+		return FALSE;
+	CEnsureReleaseRegion erpBuffer = AllocateBuffer(maxLength * maxOutstanding, options);
 	if ((PVOID)erpBuffer == NULL)
 		return FALSE;
-	CEnsureCloseHandle hIOCP = CreateIoCompletionPort(hFile, NULL, 0, 0);
-	if (hIOCP.IsInvalid())
+	CIocpBackend backend(options, status);
+	if (!backend.Open(hFile, maxOutstanding))
 		return FALSE;
+	CRequestDrain drain(&backend, cefCompleted, maxOutstanding, nTransfersInProgress);
 
-	FiboLfsr lfsr;
-	if (ap == BENCHAP_RANDOM)
-		lfsr = SeedRandom(blocks);
-	if (randomData)
-		SeedRandomData();
-
-	for (BYTE i = 0; i < maxOutstanding; ++i)
+	QueryPerformanceFrequency(&liFrequency);
+	for (DWORD i = 0; i < maxOutstanding; ++i)
 		reqIdxStack.push(i);
 
-	while ((currentBlock < blocks || nTransfersInProgress) && !status->Canceled)
+	StartPerfCount(&liReplayStart);
+	while ((currentRecord < recordCount || nTransfersInProgress) && !status->Canceled)
 	{
-		while (currentBlock < blocks && nTransfersInProgress < maxOutstanding)
+		DWORD waitMilliseconds = INFINITE;
+		while (currentRecord < recordCount && nTransfersInProgress < maxOutstanding)
 		{
-			// Make new requests
+			const ReplayRecord& record = records[currentRecord];
+			LARGE_INTEGER liCurrentFileOffset;
+			liCurrentFileOffset.QuadPart = record.Offset;
+
+			if (timed)
+			{
+				// Requests are issued no earlier than their (scaled) trace time. Requests 
+				// that are already late are issued immediately and the lateness is recorded.
+				LARGE_INTEGER liNow;
+				QueryPerformanceCounter(&liNow);
+				LONGLONG dueCount = liReplayStart.QuadPart + 
+					(LONGLONG)((double)record.IssueTime * timeScale * liFrequency.QuadPart / 1000000);
+				if (liNow.QuadPart < dueCount)
+				{
+					waitMilliseconds = (DWORD)((dueCount - liNow.QuadPart) * 1000 / liFrequency.QuadPart);
+					break;
+				}
+				stats->ScheduleLagPerfCounts += liNow.QuadPart - dueCount;
+			}
+
 			DWORD currentReqIdx = reqIdxStack.top(); 
 			reqIdxStack.pop();
-			LPOVERLAPPED currentReq = cefOverlappeds + currentReqIdx;
-			PVOID currentBuffer = (PBYTE)erpBuffer + (currentReqIdx * blockSize);
-			if (op == BENCHOP_WRITE)
-				FillBuffer(currentBuffer, blockSize, &liCurrentFileOffset, randomData);
-			currentReq->Internal = 0;
-			currentReq->InternalHigh = 0;
-			currentReq->Offset = liCurrentFileOffset.LowPart;
-			currentReq->OffsetHigh = liCurrentFileOffset.HighPart;
-			currentReq->hEvent = 0;
+			IoRequest* currentReq = cefRequests + currentReqIdx;
+			currentReq->Operation = record.Op;
+			currentReq->Buffer = (PBYTE)erpBuffer + (currentReqIdx * maxLength);
+			currentReq->Segments = NULL;
+			currentReq->Length = record.Length;
+			currentReq->Offset = liCurrentFileOffset;
+			if (record.Op == BENCHOP_WRITE)
+				CDataPattern::Fill(currentReq->Buffer, record.Length, &liCurrentFileOffset);
 
 			StartPerfCount(&liPerfCount);
-			if (op == BENCHOP_WRITE)
-				bOk = WriteFile(hFile, currentBuffer, blockSize, NULL, currentReq);
-			else
-				bOk = ReadFile(hFile, currentBuffer, blockSize, NULL, currentReq);
-			StopAndAccumPerfCount(&liPerfCount, &status->ReadWriteFilePerfCounts);
-			if (bOk)
-				++(status->CompletedSync);
-			else if (GetLastError() != ERROR_IO_PENDING)
+			currentReq->SubmitTime = liPerfCount;
+			if (!backend.Submit(currentReq))
 				return FALSE;
+			StopAndAccumPerfCount(&liPerfCount, &stats->ReadWriteFilePerfCounts);
+			++(stats->SubmitCalls);
+			if (currentReq->Synchronous)
+				++(stats->CompletedSync);
 			else
-				++(status->CompletedAsync);
+				++(stats->CompletedAsync);
 
-			if (ap == BENCHAP_SEQUENTIAL)
-				liCurrentFileOffset.QuadPart += blockSize;
-			else
-				SetNextRandomOffset(&liCurrentFileOffset, blockSize, lfsr);
 			nTransfersInProgress++;
-			++currentBlock;
+			++currentRecord;
 		}
 
-		// Process completed requests
+		if (nTransfersInProgress == 0)
+		{
+			// Nothing in flight, just waiting for the next request to become due.
+			if (currentRecord < recordCount)
+				Sleep(waitMilliseconds);
+			continue;
+		}
+
+		// Process completed requests, or none if the next request falls due first
 		ULONG entriesRemoved = 0;
 		StartPerfCount(&liPerfCount);
-		if (!GetQueuedCompletionStatusEx(hIOCP, cefOverlappedEntries, maxOutstanding, &entriesRemoved, INFINITE, FALSE))
+		if (!backend.Reap(cefCompleted, maxOutstanding, waitMilliseconds, &entriesRemoved, &stats->CompletionCalls))
 			return FALSE;
-		StopAndAccumPerfCount(&liPerfCount, &status->GetQueuedCompletionStatusExPerfCounts);
+		StopAndAccumPerfCount(&liPerfCount, &stats->GetQueuedCompletionStatusExPerfCounts);
+		nTransfersInProgress -= entriesRemoved;
+		LARGE_INTEGER liCompleted;
+		QueryPerformanceCounter(&liCompleted);
 
+		ULONGLONG bytesRemoved = 0;
 		for (ULONG i = 0; i < entriesRemoved; ++i)
 		{
-			OVERLAPPED_ENTRY& entry = cefOverlappedEntries[i];
-			if (entry.dwNumberOfBytesTransferred != blockSize || entry.lpOverlapped->Internal != 0)
+			IoRequest* currentReq = cefCompleted[i];
+			DWORD reqIdx = (DWORD)(currentReq - cefRequests);
+			if (currentReq->Error != ERROR_SUCCESS || currentReq->BytesTransferred != currentReq->Length)
 			{
-				// Safe to explictly truncate Internal on 64-bit.
-				SetLastError((DWORD)entry.lpOverlapped->Internal);
+				SetLastError(currentReq->Error != ERROR_SUCCESS ? currentReq->Error : ERROR_HANDLE_EOF);
 				return FALSE;
 			}
-			// Safely truncate pointer arithmetic to BYTE. MaxOutstanding is never larger than BYTE range.
-			BYTE reqIdx = (BYTE)(entry.lpOverlapped - cefOverlappeds);	
-			if (op == BENCHOP_READ && verify)
-			{ 
-				LARGE_INTEGER liOffset;
-				liOffset.LowPart = entry.lpOverlapped->Offset;
-				liOffset.HighPart = entry.lpOverlapped->OffsetHigh;			
-				PVOID buffer = (PBYTE)erpBuffer + (reqIdx * blockSize);
-				if (!VerifyBuffer(buffer, blockSize, &liOffset))
-				{
-					SetLastError(ERROR_CRC);
-					return FALSE;
-				}
-			}
+			RecordLatency(&status->Latency, PerfCountToMicroseconds(liCompleted.QuadPart - currentReq->SubmitTime.QuadPart, liFrequency.QuadPart));
+			bytesRemoved += currentReq->Length;
 			reqIdxStack.push(reqIdx);
 		}
 
-		nTransfersInProgress -= entriesRemoved;
-		status->BlocksTransferred += entriesRemoved;
-	}
-
-	return TRUE;
-}
-
-FiboLfsr SeedRandom(DWORD blocks)
-{
-	UCHAR bitWidth = 0;
-	while (blocks >>= 1) ++bitWidth;
-	return FiboLfsr(bitWidth);
-}
-
-void SetNextRandomOffset(PLARGE_INTEGER pliOffset, DWORD blockSize, FiboLfsr& lfsr)
-{
-	DWORD block = lfsr.Next();
-	pliOffset->QuadPart = (long)blockSize * block;
-}
-
-BOOL SynchronousOp(HANDLE hFile, DWORD op, DWORD ap, BOOL verify, DWORD blocks, DWORD blockSize, BOOL randomData, Status* status)
-{
-	BOOL bOk;
-	DWORD currentBlock = 0;
-	
-	DWORD nBytesTransferred = 0;
-	LARGE_INTEGER liCurrentFileOffset = { 0 };
-	LARGE_INTEGER liPerfCount;
-
-	CEnsureReleaseRegion erpBuffer = VirtualAlloc(NULL, blockSize, MEM_COMMIT, PAGE_READWRITE);
-	if ((PVOID)erpBuffer == NULL)
-		return FALSE;
-
-	if (INVALID_SET_FILE_POINTER == SetFilePointer(hFile, 0, NULL, FILE_BEGIN))
-		return FALSE;
-
-	FiboLfsr lfsr;
-	if (ap == BENCHAP_RANDOM)
-		lfsr = SeedRandom(blocks);
-	if (randomData)
-		SeedRandomData();
-
-	while (currentBlock < blocks && !status->Canceled)
-	{
-		if (op == BENCHOP_WRITE)
-			FillBuffer(erpBuffer, blockSize, &liCurrentFileOffset, randomData);
-
-		StartPerfCount(&liPerfCount);
-		if (op == BENCHOP_WRITE)
-			bOk = WriteFile(hFile, erpBuffer, blockSize, &nBytesTransferred, NULL);
-		else
-			bOk = ReadFile(hFile, erpBuffer, blockSize, &nBytesTransferred, NULL);
-		StopAndAccumPerfCount(&liPerfCount, &status->ReadWriteFilePerfCounts);
-		if (!bOk || nBytesTransferred != blockSize)
-			return FALSE;
-
-		if (op == BENCHOP_READ && verify && !VerifyBuffer(erpBuffer, blockSize, &liCurrentFileOffset))
-		{
-			SetLastError(ERROR_CRC);
-			return FALSE;
-		}
-
-		if (ap == BENCHAP_SEQUENTIAL)
-			liCurrentFileOffset.QuadPart += blockSize;
-		else
-		{
-			SetNextRandomOffset(&liCurrentFileOffset, blockSize, lfsr);
-			if (!SetFilePointerEx(hFile, liCurrentFileOffset, NULL, FILE_BEGIN))
-				return FALSE;
-		}
-		++currentBlock;
-
-		++(status->BlocksTransferred);
-		++(status->CompletedSync);
+		stats->InFlight = nTransfersInProgress;
+		AddProgress(stats, entriesRemoved, bytesRemoved, 0);
 	}
 
 	return TRUE;
@@ -224,8 +203,6 @@ typedef NTSTATUS (NTAPI *NtFsControlFilePtr)
     IN ULONG OutputBufferLength
     );
 
-static NtFsControlFilePtr pNtFsControlFile = NULL;
-
 BOOL DisableLocalBuffering(HANDLE hFile, BOOL isAsync)
 {
 	return CallNtFsControlFile(hFile, isAsync, IOCTL_LMR_DISABLE_LOCAL_BUFFERING, NULL, 0);
@@ -233,15 +210,10 @@ BOOL DisableLocalBuffering(HANDLE hFile, BOOL isAsync)
 
 BOOL CallNtFsControlFile(HANDLE hFile, BOOL isAsync, ULONG IoControlCode, PVOID InputBuffer, ULONG InputBufferLength)
 {
+	// ntdll is mapped into every process, so the lookup is cheap enough to repeat per call.
+	NtFsControlFilePtr pNtFsControlFile = (NtFsControlFilePtr)GetProcAddress(GetModuleHandle(L"ntdll.dll"), "NtFsControlFile");
 	if (pNtFsControlFile == NULL)
-	{
-		CEnsureFreeLibrary hModule = LoadLibrary(L"ntdll.dll");
-		if (hModule.IsInvalid())
-			return FALSE;
-		pNtFsControlFile = (NtFsControlFilePtr)GetProcAddress(hModule, "NtFsControlFile");
-		if (pNtFsControlFile == NULL)
-			return FALSE;
-	}
+		return FALSE;
 
 	IO_STATUS_BLOCK ioStatusBlock = { 0 };
 	if (!NT_SUCCESS(pNtFsControlFile(hFile, NULL, NULL, NULL, &ioStatusBlock, IoControlCode, InputBuffer, InputBufferLength, NULL, 0)))
@@ -267,6 +239,15 @@ BOOL Experimental_EnableRemotePrefetch(HANDLE hFile, BOOL isAsync)
 	return CallNtFsControlFile(hFile, isAsync, FSCTL_LMR_GET_HINT_SIZE, &inBuffer, 2);
 }
 
+// The hint is held by the file object, so it applies to every request issued through this 
+// handle. User mode may only ask for very low, low or normal priority.
+BOOL SetIoPriorityHint(HANDLE hFile, DWORD priority)
+{
+	FILE_IO_PRIORITY_HINT_INFO hint;
+	hint.PriorityHint = (PRIORITY_HINT)priority;
+	return SetFileInformationByHandle(hFile, FileIoPriorityHintInfo, &hint, sizeof(hint));
+}
+
 BOOL PreallocZeroed(HANDLE hFile, LARGE_INTEGER liFileSize, BOOL isAsync)
 {
 	BOOL bOk;
@@ -311,63 +292,24 @@ BOOL PreallocZeroed(HANDLE hFile, LARGE_INTEGER liFileSize, BOOL isAsync)
 	return TRUE;
 }
 
-void FillBuffer(PVOID pBuffer, DWORD dwBufferSize, PLARGE_INTEGER pliOffset, BOOL randomData) 
+BOOL PrepareTrim(HANDLE hFile, DWORD trimType, BOOL isAsync)
 {
-	_ASSERT(dwBufferSize % sizeof(LONGLONG) == 0);
-	LONGLONG recordIndex = pliOffset->QuadPart / sizeof(LONGLONG);
-	PLONGLONG pllBuff = (PLONGLONG)pBuffer;
-	PVOID pEnd = (PBYTE)pBuffer + dwBufferSize;
-
-	if (randomData) {
-		for	(; pllBuff < pEnd; ++pllBuff)
-			*pllBuff = GetRandomData();
-	} else {
-		for	(; pllBuff < pEnd; ++pllBuff, ++recordIndex)
-			*pllBuff = recordIndex;
-	}
-}
-
-BOOL VerifyBuffer(PVOID pBuffer, DWORD dwBufferSize, PLARGE_INTEGER pliOffset) 
-{
-	_ASSERT(dwBufferSize % sizeof(LONGLONG) == 0);
-	LONGLONG recordIndex = pliOffset->QuadPart / sizeof(LONGLONG);
-	PLONGLONG pllBuff = (PLONGLONG)pBuffer;
-	PVOID pEnd = (PBYTE)pBuffer + dwBufferSize;
-	for	(; pllBuff < pEnd; ++pllBuff, ++recordIndex)
-		if (*pllBuff != recordIndex) 
-			return FALSE;
-	return TRUE;
-}
-
-void StartPerfCount(PLARGE_INTEGER pliStart)
-{
-	QueryPerformanceCounter(pliStart);
-}
-
-void StopPerfCount(PLARGE_INTEGER pliStart, PULONGLONG duration)
-{
-	LARGE_INTEGER liStop;
-	QueryPerformanceCounter(&liStop);
-	*duration = liStop.QuadPart - pliStart->QuadPart; // need force atomic?
-}
-
-void StopAndAccumPerfCount(PLARGE_INTEGER pliStart, PULONGLONG accumulator)
-{
-	ULONGLONG liDuration;
-	StopPerfCount(pliStart, &liDuration);
-	*accumulator += liDuration; // need force atomic?
-}
-
-/* Random Data */
+	if (trimType != BENCHTRIM_PUNCH)
+		return TRUE;
 
-std::tr1::mt19937_64 mtEngine;
+	// Zeroing a range only deallocates it, and so trims the blocks beneath, in a sparse file.
+	DWORD bytesReturned;
+	if (!isAsync)
+		return DeviceIoControl(hFile, FSCTL_SET_SPARSE, NULL, 0, NULL, 0, &bytesReturned, NULL);
 
-void SeedRandomData()
-{
-	mtEngine = std::tr1::mt19937_64(time(NULL));
-}
+	CEnsureCloseHandle hEvent;
+	hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (hEvent.IsInvalid())
+		return FALSE;
 
-LONGLONG GetRandomData()
-{
-	return mtEngine();
+	OVERLAPPED overlapped = { 0 };
+	overlapped.hEvent = hEvent;
+	if (!DeviceIoControl(hFile, FSCTL_SET_SPARSE, NULL, 0, NULL, 0, NULL, &overlapped) && GetLastError() != ERROR_IO_PENDING)
+		return FALSE;
+	return GetOverlappedResult(hFile, &overlapped, &bytesReturned, TRUE);
 }
@@ -19,32 +19,31 @@
 #define IOBENCH_API __declspec(dllimport)
 #endif
 
-#define BENCHOP_WRITE 1
-#define BENCHOP_READ  2
-#define BENCHAP_SEQUENTIAL 1
-#define BENCHAP_RANDOM     2
+#include "OpOptions.h"
 
 struct Status;
-class FiboLfsr;
+struct ReplayRecord;
+struct CpuUsage;
+struct WalOptions;
+struct WalResult;
+struct DeviceInfo;
 
 extern "C" {
 
 IOBENCH_API BOOL Experimental_EnableRemotePrefetch(HANDLE hFile, BOOL isAsync);
 IOBENCH_API BOOL DisableLocalBuffering(HANDLE hFile, BOOL isAsync);
 IOBENCH_API BOOL PreallocZeroed(HANDLE hFile, LARGE_INTEGER liFileSize, BOOL isAsync);
-IOBENCH_API BOOL AsynchronousOp(HANDLE hFile, DWORD op, DWORD ap, BOOL verify, DWORD blocks, DWORD blockSize, BOOL randomData, DWORD maxOutstanding, Status* status);
-IOBENCH_API BOOL SynchronousOp(HANDLE hFile, DWORD op, DWORD ap, BOOL verify, DWORD blocks, DWORD blockSize, BOOL randomData, Status* status);
+IOBENCH_API BOOL SetIoPriorityHint(HANDLE hFile, DWORD priority);
+IOBENCH_API BOOL PrepareTrim(HANDLE hFile, DWORD trimType, BOOL isAsync);
+IOBENCH_API BOOL AsynchronousOp(HANDLE hFile, DWORD op, DWORD ap, BOOL verify, ULONGLONG blocks, DWORD blockSize, BOOL randomData, DWORD maxOutstanding, const OpOptions* options, Status* status);
+IOBENCH_API BOOL SynchronousOp(HANDLE hFile, DWORD op, DWORD ap, BOOL verify, ULONGLONG blocks, DWORD blockSize, BOOL randomData, const OpOptions* options, Status* status);
+IOBENCH_API BOOL GetThreadCpuUsage(CpuUsage* usage);
+IOBENCH_API BOOL GetThreadContextSwitches(PULONGLONG contextSwitches);
+IOBENCH_API BOOL ReplayOp(HANDLE hFile, const ReplayRecord* records, DWORD recordCount, DWORD maxLength, BOOL timed, double timeScale, DWORD maxOutstanding, const OpOptions* options, Status* status);
+IOBENCH_API BOOL GetDeviceNumaNode(LPCWSTR path, PDWORD numaNode);
+IOBENCH_API BOOL WalOp(HANDLE hFile, const WalOptions* wal, const OpOptions* options, Status* status, WalResult* result);
+IOBENCH_API BOOL GetDeviceInfo(LPCWSTR path, DeviceInfo* info);
 
 }
 
 BOOL CallNtFsControlFile(HANDLE hFile, BOOL isAsync, ULONG IoControlCode, PVOID InputBuffer, ULONG InputBufferLength);
-FiboLfsr SeedRandom(DWORD blocks);
-void SetNextRandomOffset(PLARGE_INTEGER pliOffset, DWORD blockSize, FiboLfsr& lfsr);
-void FillBuffer(PVOID pBuffer, DWORD dwBufferSize, PLARGE_INTEGER pliOffset, BOOL randomData);
-BOOL VerifyBuffer(PVOID pBuffer, DWORD dwBufferSize, PLARGE_INTEGER pliOffset); 
-void StartPerfCount(PLARGE_INTEGER pliStart);
-void StopPerfCount(PLARGE_INTEGER pliStart, PULONGLONG duration);
-void StopAndAccumPerfCount(PLARGE_INTEGER pliStart, PULONGLONG accumulator);
-
-void SeedRandomData();
-LONGLONG GetRandomData();
\ No newline at end of file
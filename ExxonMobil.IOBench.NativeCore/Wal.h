@@ -0,0 +1,105 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <Windows.h>
+#include <random>
+#include "ResourceHelper.h"
+
+#define WAL_RECORD_FIXED       0
+#define WAL_RECORD_UNIFORM     1
+#define WAL_RECORD_EXPONENTIAL 2
+#define WAL_ALIGNMENT          4096
+#define WAL_MAX_PRODUCERS      MAXIMUM_WAIT_OBJECTS
+
+struct Status;
+struct OpOptions;
+
+// Shape of a write-ahead log workload. Layout is shared with the managed NativeWalOptions.
+struct WalOptions
+{
+	ULONGLONG Records;          // records appended over all producers
+	DWORD Producers;            // threads appending records
+	DWORD RecordModel;          // WAL_RECORD_*
+	DWORD RecordBytes;          // size of WAL_RECORD_FIXED, mean of WAL_RECORD_EXPONENTIAL
+	DWORD MinRecordBytes;       // bounds of WAL_RECORD_UNIFORM and WAL_RECORD_EXPONENTIAL
+	DWORD MaxRecordBytes;
+	DWORD MaxGroupBytes;        // a group is written as soon as this much is waiting
+	DWORD CommitMicroseconds;   // longest the first record of a group waits for others to join it
+	BOOL Flush;                 // FlushFileBuffers after every group write
+};
+
+// Totals of a log run. Layout is shared with the managed NativeWalResult.
+struct WalResult
+{
+	ULONGLONG Commits;
+	ULONGLONG Records;
+	ULONGLONG RecordBytes;
+	ULONGLONG PaddingBytes;
+};
+
+// Records appended by producer threads are gathered into a group in memory. A single writer 
+// pads each group to WAL_ALIGNMENT, writes it at the end of the log and flushes it, then 
+// wakes every producer whose record it held. Producers fill one buffer while the writer 
+// writes the other, so a group builds up for as long as the previous commit takes.
+class CGroupCommitLog
+{
+public:
+	CGroupCommitLog(HANDLE hFile, const WalOptions* wal, const OpOptions* options, Status* status);
+	~CGroupCommitLog();
+
+	BOOL Run(WalResult* result);
+
+private:
+	struct Group
+	{
+		ULONGLONG Sequence;
+		PBYTE Buffer;
+		DWORD Bytes;
+		DWORD Records;
+	};
+
+	static DWORD WINAPI ProducerThread(LPVOID param);
+	void Produce(DWORD producer);
+	DWORD NextRecordBytes(std::tr1::mt19937_64& engine);
+	BOOL Commit(const BYTE* record, DWORD length);
+	BOOL TakeGroup(Group* group);
+	void FinishGroup(const Group* group);
+	void Fail(DWORD error);
+	void StopProducers();
+
+	HANDLE m_hFile;
+	const WalOptions* m_pWal;
+	const OpOptions* m_pOptions;
+	Status* m_pStatus;
+	LONGLONG m_llFrequency;
+
+	SRWLOCK m_lock;
+	CONDITION_VARIABLE m_cvGroupReady;  // the writer waits for a group to write
+	CONDITION_VARIABLE m_cvSpace;       // producers wait for the filling buffer to be swapped
+	CONDITION_VARIABLE m_cvCommitted;   // producers wait for their group to be durable
+
+	CEnsureReleaseRegion m_erpBuffers;  // two buffers of MaxGroupBytes, filled in turn
+	DWORD m_dwFilling;                  // index of the buffer producers append to
+	DWORD m_dwFill;                     // bytes appended to it
+	DWORD m_dwFillRecords;
+	LONGLONG m_llGroupOpened;           // performance count of the first append to it
+	ULONGLONG m_ullOpenGroup;           // sequence of the group being filled
+	ULONGLONG m_ullDurableGroup;        // last group written and flushed
+	DWORD m_dwActiveProducers;
+	DWORD m_dwError;
+	HANDLE m_hThreads[WAL_MAX_PRODUCERS];
+	DWORD m_dwThreads;
+	volatile LONG m_lNextProducer;
+};
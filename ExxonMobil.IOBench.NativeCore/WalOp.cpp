@@ -0,0 +1,314 @@
+// Copyright 2014 ExxonMobil Technical Computing Company
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "stdafx.h"
+#include "NativeCore.h"
+#include "ResourceHelper.h"
+#include "Status.h"
+#include "StatWriter.h"
+#include "OpOptions.h"
+#include "Placement.h"
+#include "PerfCount.h"
+#include "Wal.h"
+
+#include <math.h>
+#include <time.h>
+
+CGroupCommitLog::CGroupCommitLog(HANDLE hFile, const WalOptions* wal, const OpOptions* options, Status* status)
+	: m_hFile(hFile), m_pWal(wal), m_pOptions(options), m_pStatus(status), m_llFrequency(0),
+	m_dwFilling(0), m_dwFill(0), m_dwFillRecords(0), m_llGroupOpened(0), m_ullOpenGroup(1), m_ullDurableGroup(0),
+	m_dwActiveProducers(0), m_dwError(ERROR_SUCCESS), m_dwThreads(0), m_lNextProducer(0)
+{
+	InitializeSRWLock(&m_lock);
+	InitializeConditionVariable(&m_cvGroupReady);
+	InitializeConditionVariable(&m_cvSpace);
+	InitializeConditionVariable(&m_cvCommitted);
+}
+
+CGroupCommitLog::~CGroupCommitLog()
+{
+	StopProducers();
+}
+
+// The calling thread is the writer. It returns once every producer has appended its share of 
+// the records and every group holding them is durable.
+BOOL CGroupCommitLog::Run(WalResult* result)
+{
+	ZeroMemory(result, sizeof(WalResult));
+
+	LARGE_INTEGER liFrequency;
+	QueryPerformanceFrequency(&liFrequency);
+	m_llFrequency = liFrequency.QuadPart;
+
+	CThreadPlacement placement;
+	if (!placement.Apply(m_pOptions))
+		return FALSE;
+	m_erpBuffers = AllocateBuffer((SIZE_T)m_pWal->MaxGroupBytes * 2, m_pOptions);
+	if ((PVOID)m_erpBuffers == NULL)
+		return FALSE;
+
+	m_dwActiveProducers = m_pWal->Producers;
+	for (DWORD i = 0; i < m_pWal->Producers; ++i)
+	{
+		HANDLE hThread = CreateThread(NULL, 0, ProducerThread, this, 0, NULL);
+		if (hThread == NULL)
+		{
+			DWORD error = GetLastError();
+			AcquireSRWLockExclusive(&m_lock);
+			m_dwActiveProducers -= m_pWal->Producers - i;
+			ReleaseSRWLockExclusive(&m_lock);
+			Fail(error);
+			break;
+		}
+		m_hThreads[m_dwThreads++] = hThread;
+	}
+
+	CStatWriter stats(m_pStatus, STAT_LOOP_WORKER);
+	LARGE_INTEGER liPerfCount;
+	Group group;
+	while (TakeGroup(&group))
+	{
+		DWORD padded = (group.Bytes + WAL_ALIGNMENT - 1) / WAL_ALIGNMENT * WAL_ALIGNMENT;
+		ZeroMemory(group.Buffer + group.Bytes, padded - group.Bytes);
+
+		DWORD nBytesWritten = 0;
+		StartPerfCount(&liPerfCount);
+		BOOL bOk = WriteFile(m_hFile, group.Buffer, padded, &nBytesWritten, NULL) && nBytesWritten == padded;
+		++(stats->SubmitCalls);
+		if (bOk && m_pWal->Flush)
+		{
+			// Flushes are the log's completion calls; the group is not committed until it returns.
+			bOk = FlushFileBuffers(m_hFile);
+			++(stats->CompletionCalls);
+		}
+		StopAndAccumPerfCount(&liPerfCount, &stats->ReadWriteFilePerfCounts);
+		if (!bOk)
+		{
+			Fail(GetLastError());
+			break;
+		}
+		FinishGroup(&group);
+
+		++(result->Commits);
+		result->Records += group.Records;
+		result->RecordBytes += group.Bytes;
+		result->PaddingBytes += padded - group.Bytes;
+		++(stats->CompletedSync);
+		AddProgress(stats, group.Records, padded, 0);
+	}
+
+	StopProducers();
+	if (m_dwError != ERROR_SUCCESS)
+	{
+		SetLastError(m_dwError);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+DWORD WINAPI CGroupCommitLog::ProducerThread(LPVOID param)
+{
+	CGroupCommitLog* log = (CGroupCommitLog*)param;
+	log->Produce((DWORD)InterlockedIncrement(&log->m_lNextProducer) - 1);
+	return 0;
+}
+
+// Appends this producer's share of the records one at a time, each waiting for its commit the 
+// way a transaction waits before it returns. Latency runs from the append to the commit.
+void CGroupCommitLog::Produce(DWORD producer)
+{
+	ULONGLONG records = m_pWal->Records / m_pWal->Producers;
+	if (producer < m_pWal->Records % m_pWal->Producers)
+		++records;
+
+	CThreadPlacement placement;
+	CEnsureHeapFree<PBYTE> cefRecord = HeapAlloc(GetProcessHeap(), 0, m_pWal->MaxRecordBytes);
+	if (!placement.Apply(m_pOptions))
+		Fail(GetLastError());
+	else if ((PBYTE)cefRecord == NULL)
+		Fail(ERROR_NOT_ENOUGH_MEMORY);
+	else
+	{
+		FillMemory(cefRecord, m_pWal->MaxRecordBytes, (BYTE)producer);
+		std::tr1::mt19937_64 engine((ULONGLONG)time(NULL) * WAL_MAX_PRODUCERS + producer);
+		LARGE_INTEGER liAppended;
+		LARGE_INTEGER liCommitted;
+		for (ULONGLONG i = 0; i < records && !m_pStatus->Canceled; ++i)
+		{
+			DWORD length = NextRecordBytes(engine);
+			QueryPerformanceCounter(&liAppended);
+			if (!Commit(cefRecord, length))
+				break;
+			QueryPerformanceCounter(&liCommitted);
+			RecordLatencyInterlocked(&m_pStatus->Latency, PerfCountToMicroseconds(liCommitted.QuadPart - liAppended.QuadPart, m_llFrequency));
+		}
+	}
+
+	AcquireSRWLockExclusive(&m_lock);
+	--m_dwActiveProducers;
+	WakeConditionVariable(&m_cvGroupReady);
+	ReleaseSRWLockExclusive(&m_lock);
+}
+
+DWORD CGroupCommitLog::NextRecordBytes(std::tr1::mt19937_64& engine)
+{
+	if (m_pWal->RecordModel == WAL_RECORD_UNIFORM)
+		return m_pWal->MinRecordBytes + (DWORD)(engine() % (m_pWal->MaxRecordBytes - m_pWal->MinRecordBytes + 1));
+	if (m_pWal->RecordModel != WAL_RECORD_EXPONENTIAL)
+		return m_pWal->RecordBytes;
+
+	// Inverse transform of a uniform draw in [0, 1), clamped to the record size bounds.
+	double uniform = (double)(engine() >> 11) / (double)(1ULL << 53);
+	double bytes = -log(1.0 - uniform) * m_pWal->RecordBytes;
+	if (bytes < m_pWal->MinRecordBytes)
+		return m_pWal->MinRecordBytes;
+	if (bytes > m_pWal->MaxRecordBytes)
+		return m_pWal->MaxRecordBytes;
+	return (DWORD)bytes;
+}
+
+BOOL CGroupCommitLog::Commit(const BYTE* record, DWORD length)
+{
+	AcquireSRWLockExclusive(&m_lock);
+	while (m_dwError == ERROR_SUCCESS && m_dwFill + length > m_pWal->MaxGroupBytes)
+		SleepConditionVariableSRW(&m_cvSpace, &m_lock, INFINITE, 0);
+	if (m_dwError != ERROR_SUCCESS)
+	{
+		ReleaseSRWLockExclusive(&m_lock);
+		return FALSE;
+	}
+
+	if (m_dwFill == 0)
+	{
+		LARGE_INTEGER liNow;
+		QueryPerformanceCounter(&liNow);
+		m_llGroupOpened = liNow.QuadPart;
+	}
+	PBYTE buffer = (PBYTE)m_erpBuffers + (SIZE_T)m_dwFilling * m_pWal->MaxGroupBytes;
+	CopyMemory(buffer + m_dwFill, record, length);
+	m_dwFill += length;
+	++m_dwFillRecords;
+	ULONGLONG group = m_ullOpenGroup;
+
+	WakeConditionVariable(&m_cvGroupReady);
+	while (m_dwError == ERROR_SUCCESS && m_ullDurableGroup < group)
+		SleepConditionVariableSRW(&m_cvCommitted, &m_lock, INFINITE, 0);
+
+	BOOL bOk = m_dwError == ERROR_SUCCESS;
+	ReleaseSRWLockExclusive(&m_lock);
+	return bOk;
+}
+
+// Waits for the filling group to be due and hands it to the writer, giving producers the 
+// other buffer. A group is due once the commit interval has passed since its first record, 
+// once the next record might not fit, or once every running producer has its record in it 
+// and no more records can join. A producer has at most one record pending, so counting the 
+// records of the group counts the producers it holds. Returns FALSE when there is nothing 
+// left to write.
+BOOL CGroupCommitLog::TakeGroup(Group* group)
+{
+	LONGLONG interval = (LONGLONG)m_pWal->CommitMicroseconds * m_llFrequency / 1000000;
+
+	AcquireSRWLockExclusive(&m_lock);
+	for (;;)
+	{
+		if (m_dwError != ERROR_SUCCESS)
+			break;
+
+		if (m_dwFill == 0)
+		{
+			if (m_dwActiveProducers == 0)
+				break;
+			SleepConditionVariableSRW(&m_cvGroupReady, &m_lock, INFINITE, 0);
+			continue;
+		}
+
+		LARGE_INTEGER liNow;
+		QueryPerformanceCounter(&liNow);
+		LONGLONG waited = liNow.QuadPart - m_llGroupOpened;
+		if (waited >= interval || m_dwFill + m_pWal->MaxRecordBytes > m_pWal->MaxGroupBytes || m_dwFillRecords >= m_dwActiveProducers)
+		{
+			group->Sequence = m_ullOpenGroup++;
+			group->Buffer = (PBYTE)m_erpBuffers + (SIZE_T)m_dwFilling * m_pWal->MaxGroupBytes;
+			group->Bytes = m_dwFill;
+			group->Records = m_dwFillRecords;
+			m_dwFilling ^= 1;
+			m_dwFill = 0;
+			m_dwFillRecords = 0;
+			WakeAllConditionVariable(&m_cvSpace);
+			ReleaseSRWLockExclusive(&m_lock);
+			return TRUE;
+		}
+
+		// Condition variables time out in milliseconds. Shorter waits yield until they are up.
+		ULONGLONG remaining = PerfCountToMicroseconds(interval - waited, m_llFrequency);
+		if (remaining >= 1000)
+			SleepConditionVariableSRW(&m_cvGroupReady, &m_lock, (DWORD)(remaining / 1000), 0);
+		else
+		{
+			ReleaseSRWLockExclusive(&m_lock);
+			SwitchToThread();
+			AcquireSRWLockExclusive(&m_lock);
+		}
+	}
+	ReleaseSRWLockExclusive(&m_lock);
+	return FALSE;
+}
+
+void CGroupCommitLog::FinishGroup(const Group* group)
+{
+	AcquireSRWLockExclusive(&m_lock);
+	m_ullDurableGroup = group->Sequence;
+	WakeAllConditionVariable(&m_cvCommitted);
+	ReleaseSRWLockExclusive(&m_lock);
+}
+
+// Records the first failure and releases every waiting thread so the run can wind down.
+void CGroupCommitLog::Fail(DWORD error)
+{
+	AcquireSRWLockExclusive(&m_lock);
+	if (m_dwError == ERROR_SUCCESS)
+		m_dwError = error != ERROR_SUCCESS ? error : ERROR_GEN_FAILURE;
+	WakeAllConditionVariable(&m_cvGroupReady);
+	WakeAllConditionVariable(&m_cvSpace);
+	WakeAllConditionVariable(&m_cvCommitted);
+	ReleaseSRWLockExclusive(&m_lock);
+}
+
+void CGroupCommitLog::StopProducers()
+{
+	if (m_dwThreads == 0)
+		return;
+
+	WaitForMultipleObjects(m_dwThreads, m_hThreads, TRUE, INFINITE);
+	for (DWORD i = 0; i < m_dwThreads; ++i)
+		CloseHandle(m_hThreads[i]);
+	m_dwThreads = 0;
+}
+
+// Runs a write-ahead log workload against a synchronous handle: small records from several 
+// producers, committed in groups by aligned appends each followed by a flush.
+BOOL WalOp(HANDLE hFile, const WalOptions* wal, const OpOptions* options, Status* status, WalResult* result)
+{
+	if (wal->Producers == 0 || wal->Producers > WAL_MAX_PRODUCERS || 
+		wal->MaxGroupBytes == 0 || wal->MaxGroupBytes % WAL_ALIGNMENT != 0 ||
+		wal->MinRecordBytes == 0 || wal->MinRecordBytes > wal->MaxRecordBytes || wal->MaxRecordBytes > wal->MaxGroupBytes ||
+		(wal->RecordModel != WAL_RECORD_UNIFORM && (wal->RecordBytes == 0 || wal->RecordBytes > wal->MaxRecordBytes)))
+	{
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	CGroupCommitLog log(hFile, wal, options, status);
+	return log.Run(result);
+}
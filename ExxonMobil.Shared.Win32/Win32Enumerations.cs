@@ -48,6 +48,7 @@ namespace ExxonMobil.Shared.Win32
     [Flags]
 	public enum Win32FileAccess : uint
     {
+        AppendData = 0x4,
         Delete = 0x10000,
         ReadControl = 0x20000,
         WriteDAC = 0x40000,
@@ -32,6 +32,21 @@ namespace ExxonMobil.Shared.Win32
 			Win32FileAttributes dwFlagsAndAttributes,
 			IntPtr hTemplateFile);
 
+		[DllImport("kernel32.dll", CharSet = CharSet.Unicode, SetLastError = true)]
+		public static extern bool CreateDirectory(string lpPathName, IntPtr lpSecurityAttributes);
+
+		[DllImport("kernel32.dll", CharSet = CharSet.Unicode, SetLastError = true)]
+		public static extern bool RemoveDirectory(string lpPathName);
+
+		[DllImport("kernel32.dll", CharSet = CharSet.Unicode, SetLastError = true)]
+		public static extern bool DeleteFile(string lpFileName);
+
+		[DllImport("kernel32.dll", CharSet = CharSet.Unicode, SetLastError = true)]
+		public static extern bool MoveFileEx(string lpExistingFileName, string lpNewFileName, uint dwFlags);
+
+		[DllImport("kernel32.dll", CharSet = CharSet.Unicode, SetLastError = true)]
+		public static extern bool GetFileAttributesEx(string lpFileName, int fInfoLevelId, out Win32FileAttributeData lpFileInformation);
+
 		[DllImport("kernel32.dll", SetLastError = true)]
 		public static extern bool SetFilePointerEx(SafeFileHandle hFile, long liDistanceToMove, IntPtr lpNewFilePointer, SeekOrigin origin);
 
@@ -59,6 +74,12 @@ namespace ExxonMobil.Shared.Win32
 		[DllImport("kernel32.dll", SetLastError = true)]
 		public static extern bool GlobalMemoryStatusEx(ref MemoryStatusEx lpBuffer);
 
+		[DllImport("psapi.dll", SetLastError = true)]
+		public static extern bool GetPerformanceInfo(ref PerformanceInformation pPerformanceInformation, uint cb);
+
+		[DllImport("kernel32.dll", SetLastError = true)]
+		public static extern bool GetNumaHighestNodeNumber(out uint HighestNodeNumber);
+
 		[DllImport("kernel32.dll")]
 		public static extern uint WTSGetActiveConsoleSessionId();
 
@@ -32,6 +32,17 @@ namespace ExxonMobil.Shared.Win32
 		public int HighPart;
 	}
 
+	[StructLayout(LayoutKind.Sequential)]
+	public struct Win32FileAttributeData
+	{
+		public uint dwFileAttributes;
+		public System.Runtime.InteropServices.ComTypes.FILETIME ftCreationTime;
+		public System.Runtime.InteropServices.ComTypes.FILETIME ftLastAccessTime;
+		public System.Runtime.InteropServices.ComTypes.FILETIME ftLastWriteTime;
+		public uint nFileSizeHigh;
+		public uint nFileSizeLow;
+	}
+
 	[StructLayout(LayoutKind.Sequential)]
 	public struct MemoryStatusEx
 	{
@@ -51,6 +62,30 @@ namespace ExxonMobil.Shared.Win32
 		}
 	}
 
+	[StructLayout(LayoutKind.Sequential)]
+	public struct PerformanceInformation
+	{
+		public uint cb;
+		public UIntPtr CommitTotal;
+		public UIntPtr CommitLimit;
+		public UIntPtr CommitPeak;
+		public UIntPtr PhysicalTotal;
+		public UIntPtr PhysicalAvailable;
+		public UIntPtr SystemCache;
+		public UIntPtr KernelTotal;
+		public UIntPtr KernelPaged;
+		public UIntPtr KernelNonpaged;
+		public UIntPtr PageSize;
+		public uint HandleCount;
+		public uint ProcessCount;
+		public uint ThreadCount;
+
+		public void Initialize()
+		{
+			cb = (uint)Marshal.SizeOf(typeof(PerformanceInformation));
+		}
+	}
+
 	[StructLayout(LayoutKind.Sequential, CharSet = CharSet.Unicode)]
 	public struct DFS_INFO_3
 	{
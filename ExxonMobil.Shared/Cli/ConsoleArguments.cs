@@ -59,10 +59,14 @@ namespace ExxonMobil.Shared.Cli
 			return false;
 		}
 
-		public ConsoleArguments()
+		public ConsoleArguments() :
+			this(Environment.GetCommandLineArgs().Skip(1))
 		{
-			var rawArgs = Environment.GetCommandLineArgs();
-			foreach (string arg in rawArgs.Skip(1))
+		}
+
+		public ConsoleArguments(IEnumerable<string> args)
+		{
+			foreach (string arg in args)
 			{
 				Match match = matchNamed.Match(arg);
 				if (match.Success)